@@ -0,0 +1,107 @@
+// Микробенчмарки горячих путей, не требующие базы данных.
+// Сборка и запуск описаны в README (раздел «Бенчмарки»).
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "src/cli/standard_io_handler.hpp"
+#include "src/models/enums.hpp"
+#include "src/utils/password_utils.hpp"
+#include "src/utils/uuid_generator.hpp"
+
+namespace {
+
+void BM_HashPasswordPbkdf2(benchmark::State& state) {
+    const std::string password = "Benchmark-Passw0rd";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::PasswordUtils::hash_password_pbkdf2(password));
+    }
+}
+BENCHMARK(BM_HashPasswordPbkdf2)->Unit(benchmark::kMillisecond);
+
+void BM_VerifyPasswordPbkdf2(benchmark::State& state) {
+    const std::string password = "Benchmark-Passw0rd";
+    const std::string stored_hash = utils::PasswordUtils::hash_password_pbkdf2(password);
+    // range(0) == 0 - неверный пароль: стоимость должна совпадать с верным
+    const std::string attempt = state.range(0) ? password : "wrong-password";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::PasswordUtils::verify_password_pbkdf2(attempt, stored_hash));
+    }
+}
+BENCHMARK(BM_VerifyPasswordPbkdf2)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+void BM_GenerateUuid(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::UUIDGenerator::generate_uuid());
+    }
+}
+BENCHMARK(BM_GenerateUuid);
+
+void BM_ParseCommand(benchmark::State& state) {
+    StandardIOHandler io;
+    const std::vector<std::string> inputs = {
+        "whoami",
+        "create-user Ivan Petrov ivan.petrov@example.com USER",
+        "view-logs --level=ERROR --page=3 --page-size=50 --count=estimate",
+        "add-role \"test user@example.com\" \"engineer\" --force -v",
+    };
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io.parse_command(inputs[i++ % inputs.size()]));
+    }
+}
+BENCHMARK(BM_ParseCommand);
+
+void BM_LogLevelToString(benchmark::State& state) {
+    const models::LogLevel levels[] = {models::LogLevel::DEBUG, models::LogLevel::INFO,
+                                       models::LogLevel::WARNING, models::LogLevel::ERROR,
+                                       models::LogLevel::CRITICAL};
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(models::to_string(levels[i++ % 5]));
+    }
+}
+BENCHMARK(BM_LogLevelToString);
+
+void BM_ActionTypeToString(benchmark::State& state) {
+    const models::ActionType actions[] = {models::ActionType::SYSTEM_LOGIN,
+                                          models::ActionType::USER_CREATED,
+                                          models::ActionType::SECURITY_ACCESS_DENIED,
+                                          models::ActionType::SYSTEM_STARTUP};
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(models::to_string(actions[i++ % 4]));
+    }
+}
+BENCHMARK(BM_ActionTypeToString);
+
+void BM_StringToLogLevel(benchmark::State& state) {
+    const std::vector<std::string> names = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(models::string_to_log_level(names[i++ % names.size()]));
+    }
+}
+BENCHMARK(BM_StringToLogLevel);
+
+void BM_StringToActionType(benchmark::State& state) {
+    const std::vector<std::string> names = {"SYSTEM_LOGIN", "USER_CREATED",
+                                            "SECURITY_ACCESS_DENIED", "SYSTEM_STARTUP"};
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(models::string_to_action_type(names[i++ % names.size()]));
+    }
+}
+BENCHMARK(BM_StringToActionType);
+
+void BM_StringToPermissionType(benchmark::State& state) {
+    const std::vector<std::string> names = {"USER_READ", "LOG_EXPORT", "SYSTEM_RESTORE", "UNKNOWN"};
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(models::string_to_permission_type_optional(names[i++ % names.size()]));
+    }
+}
+BENCHMARK(BM_StringToPermissionType);
+
+} // namespace
+
+BENCHMARK_MAIN();
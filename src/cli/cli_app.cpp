@@ -1,5 +1,10 @@
 #include "cli_app.hpp"
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <vector>
 #include "commands/command_registry.hpp"
+#include "src/db/transaction_scope.hpp"
 #include "src/models/user.hpp"
 
 #include "src/services/auth_service.hpp"
@@ -54,11 +59,14 @@ void CliApp::Run() {
 
         execute_command(input);
     }
+
+    // Дописываем в БД оставшиеся в очереди записи журнала
+    log_service_->shutdown();
 }
 
-void CliApp::execute_command(const std::string &input) {
+bool CliApp::execute_command(const std::string &input) {
     auto args = io_handler_->parse_command(input);
-    if (args.positional.empty()) return;
+    if (args.positional.empty()) return true;
 
     std::string cmd_name = args.positional[0];
     args.positional.erase(args.positional.begin());
@@ -66,23 +74,159 @@ void CliApp::execute_command(const std::string &input) {
     auto it = command_map_.find(cmd_name);
     if (it == command_map_.end()) {
         io_handler_->error("Unknown command: " + cmd_name);
-        return;
+        return false;
     }
 
     BaseCommand *cmd = it->second;
 
     if (!cmd->is_visible()) {
         io_handler_->error("Command not available");
-        return;
+        return false;
     }
 
     ValidationResult result = cmd->validate_args(args);
     if (!result.valid) {
         io_handler_->error(result.error_message);
-        return;
+        return false;
+    }
+
+    return cmd->execute(args);
+}
+
+bool CliApp::is_batchable(const std::string &input) const {
+    auto args = io_handler_->parse_command(input);
+    if (args.positional.empty()) return false;
+    auto it = command_map_.find(args.positional[0]);
+    return it != command_map_.end() && it->second->is_batchable();
+}
+
+BatchReport CliApp::RunBatch(std::istream &input, const BatchOptions &options) {
+    BatchReport report;
+    const auto started = std::chrono::steady_clock::now();
+
+    services::LoginResult login = auth_service_->login(options.email, options.password, "batch");
+    if (!login.success || login.password_change_required) {
+        io_handler_->error("Batch login failed for " + options.email +
+                           (login.password_change_required ? ": password change required" : ""));
+        log_service_->shutdown();
+        return report;
     }
+    report.authenticated = true;
+    app_state_->set_current_user(login.user);
+    app_state_->set_running(true);
 
-    cmd->execute(args);
+    // Открытая группа изменяющих команд и номера её успешно выполненных строк
+    std::unique_ptr<db::BatchTransaction> group;
+    std::vector<size_t> group_lines;
+
+    auto close_group = [&]() {
+        if (!group) return;
+        try {
+            group->commit();
+            report.succeeded += group_lines.size();
+            // Фонового писателя журнала в пакетном режиме нет: поправки счётчиков
+            // журнала группы переносятся сразу после её фиксации
+            log_service_->fold_rollups();
+        } catch (const std::exception &e) {
+            io_handler_->error("Commit failed, lines rolled back: " + std::string(e.what()));
+            for (size_t line_no : group_lines) {
+                io_handler_->println("line " + std::to_string(line_no) + ": ROLLED BACK");
+            }
+            report.failed += group_lines.size();
+            // Кэш пользователей мог запомнить данные откатившейся транзакции
+            user_service_->invalidate_user_cache();
+        }
+        group.reset();
+        group_lines.clear();
+        // Снимок RBAC перечитывается один раз на группу, а не после каждой команды
+        user_service_->resume_authorization_refresh();
+    };
+
+    std::string line;
+    size_t line_no = 0;
+    while (app_state_->is_running() && std::getline(input, line)) {
+        ++line_no;
+        auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        auto last = line.find_last_not_of(" \t\r");
+        std::string command = line.substr(first, last - first + 1);
+        ++report.commands;
+
+        bool batchable = options.pool && is_batchable(command);
+        if (!batchable || group_lines.size() >= options.max_group_size) {
+            close_group();
+        }
+        if (batchable && !group) {
+            try {
+                group = std::make_unique<db::BatchTransaction>(options.pool);
+                user_service_->defer_authorization_refresh();
+            } catch (const std::exception &e) {
+                io_handler_->error("Cannot open batch transaction: " + std::string(e.what()));
+            }
+        }
+
+        // Команда группы выполняется в своей точке сохранения: если она не удалась,
+        // откатываются все её изменения, а не только упавший вызов DAO
+        std::optional<db::PooledConnection> command_conn;
+        std::optional<db::Work> command_scope;
+        if (group) {
+            try {
+                command_conn.emplace(options.pool->acquire());
+                command_scope.emplace(*command_conn);
+            } catch (const std::exception &e) {
+                io_handler_->error("Cannot open savepoint: " + std::string(e.what()));
+            }
+        }
+
+        bool ok = false;
+        if (!group || command_scope) {
+            try {
+                ok = execute_command(command);
+            } catch (const std::exception &e) {
+                io_handler_->error(e.what());
+            }
+        }
+
+        if (command_scope) {
+            try {
+                if (ok) {
+                    command_scope->get().commit();
+                }
+            } catch (const std::exception &e) {
+                io_handler_->error(e.what());
+                ok = false;
+            }
+            command_scope.reset();
+            command_conn.reset();
+            if (!ok) {
+                // Кэш пользователей мог запомнить данные откатившейся команды;
+                // снимок RBAC перечитается при закрытии группы
+                user_service_->invalidate_user_cache();
+            }
+        }
+
+        io_handler_->println("line " + std::to_string(line_no) + ": " + (ok ? "OK" : "FAILED"));
+        if (!ok) {
+            ++report.failed;
+        } else if (group) {
+            group_lines.push_back(line_no);
+        } else {
+            ++report.succeeded;
+        }
+    }
+    close_group();
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    char throughput[64];
+    std::snprintf(throughput, sizeof(throughput), "%.2f s, %.1f commands/s", report.seconds,
+                  report.seconds > 0 ? report.commands / report.seconds : 0.0);
+    io_handler_->println("Batch finished: " + std::to_string(report.commands) + " commands, " +
+                         std::to_string(report.succeeded) + " succeeded, " +
+                         std::to_string(report.failed) + " failed in " + throughput);
+
+    // Дописываем в БД оставшиеся в очереди записи журнала
+    log_service_->shutdown();
+    return report;
 }
 
 void CliApp::Stop() { app_state_->set_running(false); }
@@ -3,16 +3,37 @@
 #include "app_state.hpp"
 #include "io_handler.hpp"
 #include "commands/base_command.hpp"
+#include <istream>
 #include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
 
+#include "src/db/connection_pool.hpp"
+
 #include "src/services/auth_service.hpp"
 #include "src/services/log_service.hpp"
 #include "src/services/user_service.hpp"
 #include "src/services/data_export_import_service.hpp"
 
+struct BatchOptions {
+    // Учётные данные, под которыми выполняется весь сценарий
+    std::string email;
+    std::string password;
+    // Пул для общих транзакций; без него каждая команда фиксируется отдельно
+    std::shared_ptr<db::ConnectionPool> pool = nullptr;
+    // Сколько изменяющих команд подряд объединяется в одну транзакцию
+    size_t max_group_size = 500;
+};
+
+struct BatchReport {
+    bool authenticated = false;
+    size_t commands = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    double seconds = 0.0;
+};
+
 class CliApp {
 public:
     CliApp(std::shared_ptr<services::UserService> user_service,
@@ -22,6 +43,9 @@ public:
            std::shared_ptr<IOHandler> io_handler);
 
     void Run();
+    // Выполняет команды построчно без запросов ввода; пустые строки и
+    // строки, начинающиеся с #, пропускаются
+    BatchReport RunBatch(std::istream &input, const BatchOptions &options);
     void Stop();
 
 private:
@@ -37,5 +61,6 @@ private:
     std::unordered_map<std::string, BaseCommand *> command_map_;
 
     void initialize_commands();
-    void execute_command(const std::string &input);
+    bool execute_command(const std::string &input);
+    bool is_batchable(const std::string &input) const;
 };
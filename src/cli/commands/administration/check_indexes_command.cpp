@@ -0,0 +1,55 @@
+#include "check_indexes_command.hpp"
+#include "../command_registry.hpp"
+#include "src/cli/app_state.hpp"
+#include "src/cli/io_handler.hpp"
+#include "src/services/log_service.hpp"
+#include "src/services/user_service.hpp"
+
+bool CheckIndexesCommand::execute(const CommandArgs &args) {
+    auto report = log_service_->check_index_usage();
+    if (report.empty()) {
+        io_handler_->error("Cannot read query plans");
+        return true;
+    }
+
+    size_t missing = 0;
+    for (const auto &usage : report) {
+        std::string status;
+        if (usage.uses_index) {
+            status = "index scan";
+        } else if (usage.index_available) {
+            // На малом объёме данных последовательное чтение дешевле - это не ошибка
+            status = "seq scan on current data, index available";
+        } else {
+            status = "NO INDEX";
+            ++missing;
+        }
+        io_handler_->println(usage.query + "  " + status +
+                             (usage.index_name.empty() ? "" : "  (" + usage.index_name + ")"));
+    }
+
+    io_handler_->println("----------------------------");
+    io_handler_->println(missing == 0 ? "All log queries can use an index"
+                                      : std::to_string(missing) + " queries have no usable index");
+    return true;
+}
+
+bool CheckIndexesCommand::is_visible() const {
+    auto current_user = app_state_->get_current_user();
+    return current_user && user_service_->has_role(current_user, "ADMIN");
+}
+
+namespace {
+bool registered = []() {
+    CommandRegistry::register_command(
+        "check-indexes",
+        [](auto app_state, auto io, auto auth, auto user, auto log, auto d) {
+            return std::make_unique<CheckIndexesCommand>(
+                "check-indexes",
+                "Check that log queries are served by indexes (EXPLAIN)",
+                "check-indexes",
+                app_state, io, auth, user, log, d);
+        });
+    return true;
+}();
+} // namespace
@@ -40,6 +40,10 @@ bool CreateUserCommand::is_visible() const {
     return current_user && user_service_->can_manage_users(current_user);
 }
 
+bool CreateUserCommand::is_batchable() const {
+    return true;
+}
+
 namespace {
 bool registered = []() {
     CommandRegistry::register_command(
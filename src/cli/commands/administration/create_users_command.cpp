@@ -0,0 +1,129 @@
+#include "create_users_command.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "../command_registry.hpp"
+#include "src/services/user_service.hpp"
+#include "src/utils/csv_reader.hpp"
+
+namespace {
+// --file=<path> или --file <path>
+std::string file_argument(const CommandArgs &args) {
+    auto it = args.options.find("file");
+    if (it != args.options.end()) {
+        return it->second;
+    }
+    bool flag = std::find(args.flags.begin(), args.flags.end(), "file") != args.flags.end();
+    return flag && !args.positional.empty() ? args.positional[0] : "";
+}
+
+std::string trim(const std::string &value) {
+    auto first = value.find_first_not_of(" \t");
+    if (first == std::string::npos) return "";
+    return value.substr(first, value.find_last_not_of(" \t") - first + 1);
+}
+} // namespace
+
+ValidationResult CreateUsersCommand::validate_args(const CommandArgs &args) const {
+    if (file_argument(args).empty()) {
+        return {false, "Usage: " + get_usage()};
+    }
+    return {true, ""};
+}
+
+bool CreateUsersCommand::execute(const CommandArgs &args) {
+    const std::string path = file_argument(args);
+    std::ifstream in(path);
+    if (!in) {
+        io_handler_->error("Cannot open file: " + path);
+        return false;
+    }
+
+    // Заголовок: email, first_name, last_name и необязательный roles (через ;)
+    utils::CsvReader reader(in);
+    std::vector<std::string> fields;
+    if (!reader.read_record(fields)) {
+        io_handler_->error("File is empty: " + path);
+        return false;
+    }
+    auto column = [&](const std::string &name) -> int {
+        auto it = std::find(fields.begin(), fields.end(), name);
+        return it == fields.end() ? -1 : static_cast<int>(it - fields.begin());
+    };
+    int email_col = column("email");
+    int first_col = column("first_name");
+    int last_col = column("last_name");
+    int roles_col = column("roles");
+    if (email_col < 0 || first_col < 0 || last_col < 0) {
+        io_handler_->error("CSV header must contain email, first_name and last_name");
+        return false;
+    }
+
+    std::vector<services::BulkUserRequest> requests;
+    std::vector<size_t> lines;
+    while (reader.read_record(fields)) {
+        if (fields.size() == 1 && trim(fields[0]).empty()) continue;
+        auto field = [&](int col) { return col >= 0 && col < static_cast<int>(fields.size()) ? trim(fields[col]) : ""; };
+
+        services::BulkUserRequest request{field(email_col), field(first_col), field(last_col)};
+        std::istringstream roles(field(roles_col));
+        for (std::string role; std::getline(roles, role, ';');) {
+            if (!trim(role).empty()) request.roles.push_back(trim(role));
+        }
+        requests.push_back(std::move(request));
+        lines.push_back(reader.records_read());
+    }
+
+    auto results = user_service_->create_users_bulk(requests, app_state_->get_current_user());
+
+    // Временные пароли пишутся в файл, если он указан, иначе выводятся
+    std::ofstream output;
+    auto out_it = args.options.find("output");
+    if (out_it != args.options.end()) {
+        output.open(out_it->second);
+        if (!output) {
+            io_handler_->error("Cannot open output file: " + out_it->second);
+        } else {
+            output << "email,temporary_password\n";
+        }
+    }
+
+    size_t created = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto &result = results[i];
+        std::string prefix = "line " + std::to_string(lines[i]) + ": ";
+        if (!result.success) {
+            io_handler_->println(prefix + "FAILED " + result.email + " - " + result.message);
+            continue;
+        }
+        ++created;
+        if (output.is_open()) {
+            output << result.email << "," << result.generated_password << "\n";
+            io_handler_->println(prefix + "OK " + result.email);
+        } else {
+            io_handler_->println(prefix + "OK " + result.email + " temporary password: " + result.generated_password);
+        }
+    }
+
+    io_handler_->println("Created " + std::to_string(created) + " of " + std::to_string(results.size()) + " users.");
+    return created == results.size();
+}
+
+bool CreateUsersCommand::is_visible() const {
+    auto current_user = app_state_->get_current_user();
+    return current_user && user_service_->can_manage_users(current_user);
+}
+
+namespace {
+bool registered = []() {
+    CommandRegistry::register_command(
+        "create-users",
+        [](auto app_state, auto io, auto auth, auto user_svc, auto log, auto d) {
+            return std::make_unique<CreateUsersCommand>(
+                "create-users", "Create users in bulk from a CSV file",
+                "create-users --file=<path> [--output=<path>]",
+                app_state, io, auth, user_svc, log, d);
+        });
+    return true;
+}();
+} // namespace
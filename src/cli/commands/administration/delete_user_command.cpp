@@ -1,4 +1,5 @@
 #include "delete_user_command.hpp"
+#include <algorithm>
 #include "../command_registry.hpp"
 #include "src/services/user_service.hpp"
 
@@ -19,14 +20,18 @@ bool DeleteUserCommand::execute(const CommandArgs &args) {
         return false;
     }
 
-    io_handler_->print("Are you sure you want to delete user " + target_email +
-                       "? This action cannot be undone. (y/N): ");
-    std::string confirmation = io_handler_->read_line();
-    io_handler_->println();
+    // --yes подтверждает удаление без вопроса (пакетный режим)
+    bool confirmed = std::find(args.flags.begin(), args.flags.end(), "yes") != args.flags.end();
+    if (!confirmed) {
+        io_handler_->print("Are you sure you want to delete user " + target_email +
+                           "? This action cannot be undone. (y/N): ");
+        std::string confirmation = io_handler_->read_line();
+        io_handler_->println();
 
-    if (confirmation != "y" && confirmation != "Y" && confirmation != "yes") {
-        io_handler_->println("Deletion cancelled");
-        return true;
+        if (confirmation != "y" && confirmation != "Y" && confirmation != "yes") {
+            io_handler_->println("Deletion cancelled");
+            return true;
+        }
     }
 
     auto current_user = app_state_->get_current_user();
@@ -49,13 +54,17 @@ bool DeleteUserCommand::is_visible() const {
     return current_user && user_service_->can_manage_users(current_user);
 }
 
+bool DeleteUserCommand::is_batchable() const {
+    return true;
+}
+
 namespace {
 bool registered = []() {
     CommandRegistry::register_command(
         "delete-user",
         [](auto app_state, auto io, auto auth, auto user_svc, auto log, auto d) {
             return std::make_unique<DeleteUserCommand>(
-                "delete-user", "Delete an existing user", "delete-user <email>",
+                "delete-user", "Delete an existing user", "delete-user <email> [--yes]",
                 app_state, io, auth, user_svc, log, d);
         });
     return true;
@@ -0,0 +1,56 @@
+#include "login_throttle_command.hpp"
+#include "../command_registry.hpp"
+#include "src/services/auth_service.hpp"
+
+bool LoginThrottleCommand::execute(const CommandArgs &args) {
+    auto limiter = auth_service_->rate_limiter();
+    if (!limiter) {
+        io_handler_->println("Login throttling is disabled.");
+        return true;
+    }
+
+    const auto &config = limiter->config();
+    auto stats = limiter->stats();
+    io_handler_->println("Window: " + std::to_string(config.window.count()) + "s, limits: " +
+                         std::to_string(config.max_failures_per_email) + " failures per email, " +
+                         std::to_string(config.max_attempts_per_source) + " attempts per source");
+    io_handler_->println("Tracked: " + std::to_string(stats.tracked_emails) + " emails, " +
+                         std::to_string(stats.tracked_sources) + " sources");
+    io_handler_->println("Rejected: " + std::to_string(stats.rejected_email) + " by email, " +
+                         std::to_string(stats.rejected_source) + " by source");
+
+    auto entries = limiter->entries();
+    if (entries.empty()) {
+        io_handler_->println("No login attempts in the current window.");
+        return true;
+    }
+
+    io_handler_->println("----------------------------");
+    for (const auto &entry : entries) {
+        std::string scope = entry.scope == services::ThrottleScope::EMAIL ? "email " : "source";
+        io_handler_->println(scope + "  " + entry.key + "  " + std::to_string(entry.count) +
+                             (entry.blocked ? "  BLOCKED" : ""));
+    }
+    io_handler_->println();
+    return true;
+}
+
+bool LoginThrottleCommand::is_visible() const {
+    auto current_user = app_state_->get_current_user();
+    return current_user && user_service_->has_role(current_user, "ADMIN");
+}
+
+namespace {
+bool registered = []() {
+    CommandRegistry::register_command(
+        "login-throttle",
+        [](auto app_state, auto io, auto auth, auto user, auto log, auto d) {
+            return std::make_unique<LoginThrottleCommand>(
+                "login-throttle",
+                "Show login rate limiter state",
+                "login-throttle",
+                app_state, io, auth, user, log, d);
+        });
+    return true;
+}();
+} // namespace
@@ -0,0 +1,10 @@
+#pragma once
+#include "../base_command.hpp"
+
+class LoginThrottleCommand : public BaseCommand {
+public:
+    using BaseCommand::BaseCommand;
+
+    bool execute(const CommandArgs &args) override;
+    bool is_visible() const override;
+};
@@ -52,6 +52,10 @@ bool RemoveRoleCommand::is_visible() const {
     return current_user && user_service_->can_manage_users(current_user);
 }
 
+bool RemoveRoleCommand::is_batchable() const {
+    return true;
+}
+
 namespace {
 bool registered = []() {
     CommandRegistry::register_command(
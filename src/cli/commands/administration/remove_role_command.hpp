@@ -8,4 +8,5 @@ public:
     ValidationResult validate_args(const CommandArgs &args) const override;
     bool execute(const CommandArgs &args) override;
     bool is_visible() const override;
+    bool is_batchable() const override;
 };
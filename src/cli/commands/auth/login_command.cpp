@@ -1,4 +1,5 @@
 #include "login_command.hpp"
+#include <algorithm>
 #include "../command_registry.hpp"
 #include "src/services/auth_service.hpp"
 
@@ -28,6 +29,11 @@ bool LoginCommand::execute(const CommandArgs &args) {
     // TODO: create login log
     io_handler_->println("Login successful. Welcome, " + user->email());
 
+    bool show_token = std::find(args.flags.begin(), args.flags.end(), "token") != args.flags.end();
+    if (show_token && !result.session_token.empty()) {
+        io_handler_->println("Session token: " + result.session_token);
+    }
+
     // Force password change if required
     if (result.password_change_required) {
         io_handler_->println("You must change your password now.");
@@ -65,7 +71,7 @@ bool registered = []() {
     CommandRegistry::register_command(
         "login", [](auto app_state, auto io, auto auth, auto user, auto log, auto d) {
             return std::make_unique<LoginCommand>(
-                "login", "Login with your email", "login <email>", app_state,
+                "login", "Login with your email", "login <email> [--token]", app_state,
                 io, auth, user, log, d);
         });
     return true;
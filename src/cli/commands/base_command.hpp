@@ -35,6 +35,9 @@ public:
     }
     virtual bool execute(const CommandArgs &args) = 0;
     virtual bool is_visible() const { return true; }
+    // Команда меняет данные только через DAO и в пакетном режиме может
+    // выполняться в общей транзакции с соседними такими же командами
+    virtual bool is_batchable() const { return false; }
 
     std::string get_name() const { return name_; }
     std::string get_description() const { return description_; }
@@ -1,5 +1,6 @@
 #include "import_data.hpp"
 #include "src/services/data_export_import_service.hpp"
+#include <algorithm>
 #include <memory>
 #include "../command_registry.hpp"
 
@@ -11,9 +12,14 @@ bool ImportDataCommand::execute(const CommandArgs &args) {
     }
 
     std::string file_path = args.positional[0];
+    bool merge = std::find(args.flags.begin(), args.flags.end(), "merge") != args.flags.end();
 
     // Подтверждение импорта
-    io_handler_->println("⚠️  WARNING: This will overwrite existing data!");
+    if (merge) {
+        io_handler_->println("⚠️  WARNING: Existing users and roles will be updated from the file!");
+    } else {
+        io_handler_->println("Existing users and roles will be kept, only new records are added.");
+    }
     io_handler_->print("Continue? (yes/no): ");
     std::string confirmation = io_handler_->read_line();
     
@@ -22,9 +28,12 @@ bool ImportDataCommand::execute(const CommandArgs &args) {
         return false;
     }
 
-    bool success = data_export_import_service_->import_data(file_path, current_user);
+    bool success = data_export_import_service_->import_data(file_path, current_user, merge);
     
     if (success) {
+        // Импорт мог добавить роли и назначения и изменить пользователей
+        user_service_->refresh_authorization();
+        user_service_->invalidate_user_cache();
         io_handler_->println("✅ Data imported successfully from: " + file_path);
     } else {
         io_handler_->error("❌ Failed to import data");
@@ -40,10 +49,10 @@ bool ImportDataCommand::is_visible() const {
 
 ValidationResult ImportDataCommand::validate_args(const CommandArgs &args) const {
     if (args.positional.size() == 0) {
-        return {false, "File path is required. Usage: import-users <file_path>"};
+        return {false, "File path is required. Usage: import-users <file_path> [--merge]"};
     }
     if (args.positional.size() > 1) {
-        return {false, "Too many arguments. Usage: import-users <file_path>"};
+        return {false, "Too many arguments. Usage: import-users <file_path> [--merge]"};
     }
     return {true, ""};
 }
@@ -53,7 +62,7 @@ bool registered = []() {
     CommandRegistry::register_command(
         "import-users", [](auto app_state, auto io, auto auth, auto user, auto log, auto d) {
             return std::make_unique<ImportDataCommand>(
-                "import-users", "Import user data", "import-users [filepath]", app_state, io, auth,
+                "import-users", "Import user data", "import-users [filepath] [--merge]", app_state, io, auth,
                 user, log, d);
         });
     return true;
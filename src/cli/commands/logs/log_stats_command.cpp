@@ -0,0 +1,83 @@
+#include "log_stats_command.hpp"
+#include "../command_registry.hpp"
+#include "src/cli/app_state.hpp"
+#include "src/cli/io_handler.hpp"
+#include "src/models/enums.hpp"
+#include "src/services/log_service.hpp"
+#include "src/services/user_service.hpp"
+#include <chrono>
+
+ValidationResult LogStatsCommand::validate_args(const CommandArgs &args) const {
+    for (const auto &[key, value] : args.options) {
+        if (key == "by") {
+            if (value != "hour" && value != "day") {
+                return {false, "by must be hour or day"};
+            }
+        } else if (key != "start" && key != "end") {
+            return {false, "Unknown parameter: " + key};
+        }
+    }
+    if (args.options.count("end") && !args.options.count("start")) {
+        return {false, "end requires start"};
+    }
+    return {true, ""};
+}
+
+bool LogStatsCommand::execute(const CommandArgs &args) {
+    io_handler_->println("Total logs: " + std::to_string(log_service_->get_total_log_count()));
+    for (const auto &[level, count] : log_service_->get_level_distribution()) {
+        io_handler_->println("  " + models::to_string(level) + ": " + std::to_string(count));
+    }
+
+    if (!args.options.count("start")) {
+        return true;
+    }
+
+    auto start = log_service_->parse_time(args.options.at("start"));
+    if (!start) {
+        io_handler_->println("Invalid start time: " + args.options.at("start"));
+        return true;
+    }
+    auto end = std::chrono::system_clock::now();
+    if (args.options.count("end")) {
+        auto parsed = log_service_->parse_time(args.options.at("end"));
+        if (!parsed) {
+            io_handler_->println("Invalid end time: " + args.options.at("end"));
+            return true;
+        }
+        end = *parsed;
+    }
+    std::string granularity = args.options.count("by") ? args.options.at("by") : "day";
+
+    auto histogram = log_service_->get_log_histogram(*start, end, granularity);
+    io_handler_->println("----------");
+    if (histogram.empty()) {
+        io_handler_->println("No logs in range");
+        return true;
+    }
+    for (const auto &[bucket, count] : histogram) {
+        io_handler_->println(bucket + "  " + std::to_string(count));
+    }
+    return true;
+}
+
+bool LogStatsCommand::is_visible() const {
+    auto current_user = app_state_->get_current_user();
+    return current_user && user_service_->has_role(current_user, "ADMIN");
+}
+
+namespace {
+bool registered = []() {
+    CommandRegistry::register_command(
+        "log-stats",
+        [](auto app_state, auto io, auto auth, auto user, auto log, auto d) {
+            return std::make_unique<LogStatsCommand>(
+                "log-stats",
+                "Show log counts by level and a time histogram",
+                "log-stats [--start=\"YYYY-MM-DD HH:MM:SS\"] [--end=\"YYYY-MM-DD HH:MM:SS\"] "
+                "[--by=hour|day]",
+                app_state, io, auth, user, log, d);
+        });
+    return true;
+}();
+} // namespace
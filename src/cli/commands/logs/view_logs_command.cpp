@@ -6,9 +6,42 @@
 #include "src/models/enums.hpp"
 #include "src/services/log_service.hpp"
 #include "src/services/user_service.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <optional>
 #include <sstream>
 
+namespace {
+// --follow продолжается до Ctrl+C; на это время SIGINT только снимает флаг
+volatile std::sig_atomic_t follow_interrupted = 0;
+
+void stop_following(int) {
+    follow_interrupted = 1;
+}
+
+// Возвращает прежний обработчик SIGINT при любом выходе из --follow
+class SigintGuard {
+public:
+    SigintGuard() : previous_(std::signal(SIGINT, stop_following)) {}
+    ~SigintGuard() { std::signal(SIGINT, previous_); }
+
+    SigintGuard(const SigintGuard &) = delete;
+    SigintGuard &operator=(const SigintGuard &) = delete;
+
+private:
+    void (*previous_)(int);
+};
+
+std::string format_log(const models::SystemLogView &log_entry) {
+    std::ostringstream ss;
+    ss << "[" << log_entry.timestamp << "] ["
+       << models::to_string(log_entry.level) << "] "
+       << log_entry.message;
+    return ss.str();
+}
+} // namespace
+
 ValidationResult ViewLogsCommand::validate_args(const CommandArgs &args) const {
     ValidationResult result{true, ""};
 
@@ -25,15 +58,33 @@ ValidationResult ViewLogsCommand::validate_args(const CommandArgs &args) const {
             } catch (...) {
                 return {false, "limit must be numeric"};
             }
+        } else if (key == "count") {
+            if (val != "exact" && val != "estimate") {
+                return {false, "count must be exact or estimate"};
+            }
         } else if (key == "level" || key == "action" ||
                    key == "actor" || key == "subject" ||
-                   key == "start" || key == "end") {
+                   key == "start" || key == "end" || key == "cursor" ||
+                   key == "search") {
             continue;
         } else {
             return {false, "Unknown parameter: " + key};
         }
     }
 
+    // Результаты поиска упорядочены по релевантности, а не по ключу страницы
+    if (args.options.count("search") &&
+        (args.options.count("cursor") || args.options.count("count"))) {
+        return {false, "search cannot be combined with cursor or count"};
+    }
+
+    // --all читает всё под фильтром одним проходом курсора, без страниц
+    if (std::find(args.flags.begin(), args.flags.end(), "all") != args.flags.end() &&
+        (args.options.count("search") || args.options.count("cursor") ||
+         args.options.count("count") || args.options.count("limit"))) {
+        return {false, "all cannot be combined with search, cursor, count or limit"};
+    }
+
     return result;
 }
 
@@ -99,24 +150,114 @@ bool ViewLogsCommand::execute(const CommandArgs &args) {
         }
     }
 
-    // Get logs
-    auto logs = log_service_->get_logs(level, action, actor_id, subject_id,
-                                       start_time, end_time, limit);
+    dao::LogFilter filter;
+    if (level) filter.level = *level;
+    if (action) filter.action_type = *action;
+    if (actor_id) filter.actor_id = *actor_id;
+    if (subject_id) filter.subject_id = *subject_id;
+    if (start_time) filter.start_time = *start_time;
+    if (end_time) filter.end_time = *end_time;
 
-    if (logs.empty()) {
-        io_handler_->println("No logs found");
-        return true;
+    dao::Pagination pagination;
+    pagination.page_size = limit;
+    if (args.options.count("cursor")) {
+        pagination.cursor = args.options.at("cursor");
+    }
+    if (args.options.count("count")) {
+        pagination.count_mode = args.options.at("count") == "exact"
+                                    ? dao::CountMode::EXACT
+                                    : dao::CountMode::ESTIMATE;
     }
 
-    io_handler_->println("Requested logs:");
-    io_handler_->println("----------");
+    std::string search = args.options.count("search") ? args.options.at("search") : "";
 
-    for (const auto &log_entry : logs) {
-        std::ostringstream ss;
-        ss << "[" << log_entry->timestamp() << "] ["
-           << models::to_string(log_entry->level()) << "] "
-           << log_entry->message();
-        io_handler_->println(ss.str());
+    // Подписка открывается до выборки страницы, чтобы не пропустить записи между ними
+    bool follow = std::find(args.flags.begin(), args.flags.end(), "follow") != args.flags.end();
+    std::unique_ptr<services::LogFollower> follower;
+    if (follow) {
+        dao::LogFilter follow_filter = filter;
+        follow_filter.search_query = search;
+        follower = log_service_->follow(follow_filter);
+        if (!follower) {
+            io_handler_->error("Cannot subscribe to new logs");
+            return true;
+        }
+    }
+
+    bool all = std::find(args.flags.begin(), args.flags.end(), "all") != args.flags.end();
+    if (all) {
+        io_handler_->println("Requested logs:");
+        io_handler_->println("----------");
+        size_t printed = 0;
+        bool ok = log_service_->for_each_log(filter, [this, &printed](const models::SystemLogView &log_entry) {
+            io_handler_->println(format_log(log_entry));
+            ++printed;
+            return true;
+        });
+        if (!ok) {
+            io_handler_->error("Failed to read logs");
+            return true;
+        }
+        io_handler_->println("----------");
+        io_handler_->println("Total: " + std::to_string(printed));
+    } else if (!search.empty()) {
+        auto hits = log_service_->search_logs(search, filter, limit);
+        if (hits.empty() && !follow) {
+            io_handler_->println("No logs found");
+            return true;
+        }
+
+        io_handler_->println("Search results:");
+        io_handler_->println("----------");
+        for (const auto &hit : hits) {
+            io_handler_->println("[" + hit.log->timestamp() + "] [" + hit.log->level_string() + "] " +
+                                 hit.snippet);
+        }
+    } else {
+        // Get logs
+        auto page = log_service_->get_logs_page_batch(filter, pagination);
+        const auto &logs = page.logs;
+
+        if (logs.empty() && !follow) {
+            io_handler_->println("No logs found");
+            return true;
+        }
+
+        io_handler_->println("Requested logs:");
+        io_handler_->println("----------");
+
+        for (const auto &log_entry : logs) {
+            io_handler_->println(format_log(log_entry));
+        }
+
+        if (pagination.count_mode != dao::CountMode::NONE) {
+            io_handler_->println("----------");
+            io_handler_->println(std::string("Total: ") + (page.total_is_estimate ? "~" : "") +
+                                 std::to_string(page.total_count));
+        }
+        if (!page.next_cursor.empty()) {
+            io_handler_->println("Next page: add --cursor=" + page.next_cursor);
+        }
+    }
+
+    if (follow) {
+        io_handler_->println("----------");
+        io_handler_->println("Following new logs, press Ctrl+C to stop");
+        follow_interrupted = 0;
+        SigintGuard sigint_guard;
+        while (!follow_interrupted) {
+            try {
+                for (const auto &log_entry : follower->poll(std::chrono::milliseconds(500))) {
+                    io_handler_->println(format_log(log_entry));
+                }
+            } catch (const std::exception &e) {
+                // Ожидание, прерванное Ctrl+C, - обычное завершение
+                if (!follow_interrupted) {
+                    io_handler_->error(std::string("Following stopped: ") + e.what());
+                }
+                break;
+            }
+        }
     }
 
     return true;
@@ -137,7 +278,8 @@ bool registered = []() {
                 "Show recent system logs (supports filters)",
                 "view-logs [--limit=N] [--level=LEVEL] [--action=ACTION] "
                 "[--actor=ID] [--subject=ID] [--start=\"YYYY-MM-DD HH:MM:SS\"] "
-                "[--end=\"YYYY-MM-DD HH:MM:SS\"]",
+                "[--end=\"YYYY-MM-DD HH:MM:SS\"] [--cursor=TOKEN] "
+                "[--count=exact|estimate] [--search=TEXT] [--all] [--follow]",
                 app_state, io, auth, user, log, d);
         });
     return true;
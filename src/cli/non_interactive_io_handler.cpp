@@ -0,0 +1,35 @@
+#include "non_interactive_io_handler.hpp"
+#include <stdexcept>
+
+NonInteractiveIOHandler::NonInteractiveIOHandler(std::shared_ptr<IOHandler> output)
+    : output_(std::move(output)) {}
+
+std::string NonInteractiveIOHandler::read_line(const std::string &prompt) {
+    throw std::runtime_error("Interactive input is not available in batch mode" +
+                             (prompt.empty() ? std::string() : ": " + prompt));
+}
+
+void NonInteractiveIOHandler::print(const std::string &message) {
+    output_->print(message);
+}
+
+void NonInteractiveIOHandler::println(const std::string &message) {
+    output_->println(message);
+}
+
+void NonInteractiveIOHandler::error(const std::string &message) {
+    output_->error(message);
+}
+
+std::string NonInteractiveIOHandler::read_password(const std::string &prompt) {
+    throw std::runtime_error("Password input is not available in batch mode" +
+                             (prompt.empty() ? std::string() : ": " + prompt));
+}
+
+CommandArgs NonInteractiveIOHandler::parse_command(const std::string &input) const {
+    return output_->parse_command(input);
+}
+
+bool NonInteractiveIOHandler::is_eof() const {
+    return false;
+}
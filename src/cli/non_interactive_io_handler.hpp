@@ -0,0 +1,23 @@
+#pragma once
+#include "io_handler.hpp"
+#include <memory>
+#include <string>
+
+// Обработчик ввода-вывода пакетного режима: вывод передаётся дальше, а любой
+// запрос ввода (подтверждение, пароль) - ошибка команды, а не ожидание stdin,
+// откуда может читаться сам сценарий.
+class NonInteractiveIOHandler : public IOHandler {
+public:
+    explicit NonInteractiveIOHandler(std::shared_ptr<IOHandler> output);
+
+    std::string read_line(const std::string &prompt = "") override;
+    void print(const std::string &message) override;
+    void println(const std::string &message = "") override;
+    void error(const std::string &message) override;
+    std::string read_password(const std::string &prompt = "Password: ") override;
+    CommandArgs parse_command(const std::string &input) const override;
+    bool is_eof() const override;
+
+private:
+    std::shared_ptr<IOHandler> output_;
+};
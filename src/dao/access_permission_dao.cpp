@@ -4,14 +4,69 @@
 #include <sstream>
 #include <iostream>
 #include <pqxx/pqxx>
+#include "src/db/statement_catalog.hpp"
+#include "src/db/transaction_scope.hpp"
 #include "src/utils/uuid_generator.hpp"
 #include "src/models/user_role.hpp"
 #include "src/models/user.hpp"
 
 namespace dao {
 
-AccessPermissionDAO::AccessPermissionDAO(std::shared_ptr<pqxx::connection> conn)
-    : connection_(std::move(conn)) {
+namespace {
+bool registered = []() {
+    using db::StatementCatalog;
+
+    StatementCatalog::register_statement("permission_upsert",
+        "INSERT INTO access_permission (id, name, description) VALUES ($1, $2, $3) "
+        "ON CONFLICT (id) DO UPDATE SET "
+        "name = EXCLUDED.name, "
+        "description = EXCLUDED.description");
+    StatementCatalog::register_statement("permission_find_by_id",
+        "SELECT id, name, description FROM access_permission WHERE id = $1");
+    StatementCatalog::register_statement("permission_find_by_name",
+        "SELECT id, name, description FROM access_permission WHERE name = $1");
+    StatementCatalog::register_statement("permission_find_all",
+        "SELECT id, name, description FROM access_permission ORDER BY name");
+    StatementCatalog::register_statement("permission_unlink_roles",
+        "DELETE FROM role_permission WHERE permission_id = $1");
+    StatementCatalog::register_statement("permission_delete",
+        "DELETE FROM access_permission WHERE id = $1");
+    StatementCatalog::register_statement("role_grant_permission",
+        "INSERT INTO role_permission (role_id, permission_id) VALUES ($1, $2) "
+        "ON CONFLICT (role_id, permission_id) DO NOTHING");
+    StatementCatalog::register_statement("role_revoke_permission",
+        "DELETE FROM role_permission WHERE role_id = $1 AND permission_id = $2");
+    StatementCatalog::register_statement("role_permissions",
+        "SELECT ap.id, ap.name, ap.description "
+        "FROM access_permission ap "
+        "INNER JOIN role_permission rp ON ap.id = rp.permission_id "
+        "WHERE rp.role_id = $1 "
+        "ORDER BY ap.name");
+    StatementCatalog::register_statement("role_has_permission",
+        "SELECT EXISTS ("
+        "SELECT 1 FROM role_permission rp "
+        "INNER JOIN access_permission ap ON rp.permission_id = ap.id "
+        "WHERE rp.role_id = $1 AND ap.name = $2)");
+    StatementCatalog::register_statement("roles_with_permission",
+        "SELECT ur.id, ur.name, ur.description, ur.is_system, ur.created_at, ur.updated_at "
+        "FROM user_role ur "
+        "INNER JOIN role_permission rp ON ur.id = rp.role_id "
+        "INNER JOIN access_permission ap ON rp.permission_id = ap.id "
+        "WHERE ap.name = $1 "
+        "ORDER BY ur.name");
+    StatementCatalog::register_statement("authz_role_permissions",
+        "SELECT ur.id, ur.name, ap.name AS permission_name "
+        "FROM user_role ur "
+        "LEFT JOIN role_permission rp ON ur.id = rp.role_id "
+        "LEFT JOIN access_permission ap ON rp.permission_id = ap.id");
+    StatementCatalog::register_statement("authz_user_roles",
+        "SELECT user_id, role_id FROM user_role_assignment");
+    return true;
+}();
+} // namespace
+
+AccessPermissionDAO::AccessPermissionDAO(std::shared_ptr<db::ConnectionPool> pool)
+    : pool_(std::move(pool)) {
 }
 
 bool AccessPermissionDAO::save(const std::shared_ptr<models::AccessPermission>& permission) {
@@ -20,18 +75,14 @@ bool AccessPermissionDAO::save(const std::shared_ptr<models::AccessPermission>&
             permission->set_id(utils::UUIDGenerator::generate_uuid());
         }
         
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        
+        db::Work txn_scope(conn);
         
-        txn.exec(
-            "INSERT INTO access_permission (id, name, description) "
-            "VALUES (" + 
-            txn.quote(permission->id()) + ", " +
-            txn.quote(permission->name()) + ", " +
-            txn.quote(permission->description()) + ") "
-            "ON CONFLICT (id) DO UPDATE SET "
-            "name = EXCLUDED.name, "
-            "description = EXCLUDED.description"
-        );
+        auto& txn = txn_scope.get();
+        
+        txn.exec_prepared("permission_upsert",
+            permission->id(), permission->name(), permission->description());
         
         txn.commit();
         return true;
@@ -43,9 +94,10 @@ bool AccessPermissionDAO::save(const std::shared_ptr<models::AccessPermission>&
 
 std::shared_ptr<models::AccessPermission> AccessPermissionDAO::find_by_id(const std::string& id) {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, name, description FROM access_permission WHERE id = " + txn.quote(id));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("permission_find_by_id", id);
         
         txn.commit();
         
@@ -62,9 +114,10 @@ std::shared_ptr<models::AccessPermission> AccessPermissionDAO::find_by_id(const
 
 std::shared_ptr<models::AccessPermission> AccessPermissionDAO::find_by_name(const std::string& name) {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, name, description FROM access_permission WHERE name = " + txn.quote(name));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("permission_find_by_name", name);
         
         txn.commit();
         
@@ -83,9 +136,10 @@ std::vector<std::shared_ptr<models::AccessPermission>> AccessPermissionDAO::find
     std::vector<std::shared_ptr<models::AccessPermission>> permissions;
     
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, name, description FROM access_permission ORDER BY name");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("permission_find_all");
         
         txn.commit();
         
@@ -101,11 +155,13 @@ std::vector<std::shared_ptr<models::AccessPermission>> AccessPermissionDAO::find
 
 bool AccessPermissionDAO::remove(const std::string& id) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
         
-        txn.exec("DELETE FROM role_permission WHERE permission_id = " + txn.quote(id));
+        txn.exec_prepared("permission_unlink_roles", id);
         
-        txn.exec("DELETE FROM access_permission WHERE id = " + txn.quote(id));
+        txn.exec_prepared("permission_delete", id);
         
         txn.commit();
         return true;
@@ -117,18 +173,11 @@ bool AccessPermissionDAO::remove(const std::string& id) {
 
 bool AccessPermissionDAO::assign_permission_to_role(const std::string& role_id, const std::string& permission_id) {
     try {
-        pqxx::work txn(*connection_);
-        auto existing = txn.exec(
-            "SELECT COUNT(*) FROM role_permission WHERE role_id = " + txn.quote(role_id) + 
-            " AND permission_id = " + txn.quote(permission_id));
-        
-        if (existing[0][0].as<int>() > 0) {
-            return true; // Уже назначено
-        }
-        
-        txn.exec(
-            "INSERT INTO role_permission (role_id, permission_id) VALUES (" +
-            txn.quote(role_id) + ", " + txn.quote(permission_id) + ")");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        // Уже назначенное разрешение пропускается через ON CONFLICT
+        txn.exec_prepared("role_grant_permission", role_id, permission_id);
         
         txn.commit();
         return true;
@@ -140,11 +189,11 @@ bool AccessPermissionDAO::assign_permission_to_role(const std::string& role_id,
 
 bool AccessPermissionDAO::remove_permission_from_role(const std::string& role_id, const std::string& permission_id) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
         
-        txn.exec(
-            "DELETE FROM role_permission WHERE role_id = " + txn.quote(role_id) + 
-            " AND permission_id = " + txn.quote(permission_id));
+        txn.exec_prepared("role_revoke_permission", role_id, permission_id);
         
         txn.commit();
         return true;
@@ -158,13 +207,10 @@ std::vector<std::shared_ptr<models::AccessPermission>> AccessPermissionDAO::get_
     std::vector<std::shared_ptr<models::AccessPermission>> permissions;
     
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT ap.id, ap.name, ap.description "
-            "FROM access_permission ap "
-            "INNER JOIN role_permission rp ON ap.id = rp.permission_id "
-            "WHERE rp.role_id = " + txn.quote(role_id) + " "
-            "ORDER BY ap.name");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("role_permissions", role_id);
         
         txn.commit();
         
@@ -180,110 +226,28 @@ std::vector<std::shared_ptr<models::AccessPermission>> AccessPermissionDAO::get_
 
 bool AccessPermissionDAO::role_has_permission(const std::string& role_id, const std::string& permission_name) {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT COUNT(*) FROM role_permission rp "
-            "INNER JOIN access_permission ap ON rp.permission_id = ap.id "
-            "WHERE rp.role_id = " + txn.quote(role_id) + 
-            " AND ap.name = " + txn.quote(permission_name));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("role_has_permission", role_id, permission_name);
         
         txn.commit();
         
-        return result[0][0].as<int>() > 0;
+        return result[0][0].as<bool>();
     } catch (const std::exception& e) {
         std::cerr << "Error in AccessPermissionDAO::role_has_permission: " << e.what() << std::endl;
         return false;
     }
 }
 
-void AccessPermissionDAO::initialize_system_permissions() {
-    try {
-        std::vector<std::pair<std::string, std::string>> system_permissions = {
-            {"USER_CREATE", "Create new users"},
-            {"USER_READ", "View users"},
-            {"USER_UPDATE", "Update users"},
-            {"USER_DELETE", "Delete users"},
-            {"USER_CHANGE_ROLE", "Change user roles"},
-            
-            {"ROLE_CREATE", "Create roles"},
-            {"ROLE_READ", "View roles"},
-            {"ROLE_UPDATE", "Update roles"},
-            {"ROLE_DELETE", "Delete roles"},
-            
-            {"LOG_READ", "View system logs"},
-            {"LOG_EXPORT", "Export logs"},
-            {"LOG_DELETE", "Delete logs"},
-            
-            {"SYSTEM_BACKUP", "Create system backups"},
-            {"SYSTEM_RESTORE", "Restore system from backup"},
-            {"SYSTEM_EXPORT", "Export system data"},
-            {"SYSTEM_IMPORT", "Import system data"}
-        };
-        
-        pqxx::work txn(*connection_);
-        
-        for (const auto& [name, description] : system_permissions) {
-            auto permission_id = utils::UUIDGenerator::generate_uuid();
-            
-            txn.exec(
-                "INSERT INTO access_permission (id, name, description) "
-                "VALUES (" + 
-                txn.quote(permission_id) + ", " +
-                txn.quote(name) + ", " +
-                txn.quote(description) + ") "
-                "ON CONFLICT (name) DO NOTHING"
-            );
-        }
-        
-        txn.exec(
-            "INSERT INTO user_role (id, name, description, is_system) VALUES "
-            "('role-admin', 'ADMIN', 'System Administrator', true), "
-            "('role-user', 'USER', 'Regular User', true) "
-            "ON CONFLICT (id) DO NOTHING"
-        );
-        
-        for (const auto& [name, description] : system_permissions) {
-            txn.exec(
-                "INSERT INTO role_permission (role_id, permission_id) "
-                "SELECT 'role-admin', id FROM access_permission WHERE name = " + txn.quote(name) + " "
-                "ON CONFLICT (role_id, permission_id) DO NOTHING"
-            );
-        }
-        
-        std::vector<std::string> user_permissions = {
-            "USER_READ", "ROLE_READ", "LOG_READ"
-        };
-        
-        for (const auto& permission_name : user_permissions) {
-            txn.exec(
-                "INSERT INTO role_permission (role_id, permission_id) "
-                "SELECT 'role-user', id FROM access_permission WHERE name = " + txn.quote(permission_name) + " "
-                "ON CONFLICT (role_id, permission_id) DO NOTHING"
-            );
-        }
-        
-        txn.commit();
-        
-        std::cout << "✅ System permissions initialized successfully" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "❌ Error initializing system permissions: " << e.what() << std::endl;
-        throw;
-    }
-}
-
 std::vector<std::shared_ptr<models::UserRole>> AccessPermissionDAO::get_roles_with_permission(const std::string& permission_name) {
     std::vector<std::shared_ptr<models::UserRole>> roles;
     
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT ur.id, ur.name, ur.description, ur.is_system, ur.created_at, ur.updated_at "
-            "FROM user_role ur "
-            "INNER JOIN role_permission rp ON ur.id = rp.role_id "
-            "INNER JOIN access_permission ap ON rp.permission_id = ap.id "
-            "WHERE ap.name = " + txn.quote(permission_name) + " "
-            "ORDER BY ur.name");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("roles_with_permission", permission_name);
         
         txn.commit();
         
@@ -303,6 +267,41 @@ std::vector<std::shared_ptr<models::UserRole>> AccessPermissionDAO::get_roles_wi
     return roles;
 }
 
+std::optional<AuthorizationRows> AccessPermissionDAO::load_authorization_rows() {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        AuthorizationRows rows;
+
+        auto role_result = txn.exec_prepared("authz_role_permissions");
+        rows.role_permissions.reserve(role_result.size());
+        for (const auto& row : role_result) {
+            AuthorizationRows::RolePermission entry;
+            entry.role_id = row["id"].as<std::string>();
+            entry.role_name = row["name"].as<std::string>();
+            if (!row["permission_name"].is_null()) {
+                entry.permission_name = row["permission_name"].as<std::string>();
+            }
+            rows.role_permissions.push_back(std::move(entry));
+        }
+
+        auto user_result = txn.exec_prepared("authz_user_roles");
+        rows.user_roles.reserve(user_result.size());
+        for (const auto& row : user_result) {
+            rows.user_roles.push_back({row["user_id"].as<std::string>(),
+                                       row["role_id"].as<std::string>()});
+        }
+
+        txn.commit();
+        return rows;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in AccessPermissionDAO::load_authorization_rows: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
 // Вспомогательные методы
 std::shared_ptr<models::AccessPermission> AccessPermissionDAO::permission_from_row(const pqxx::row& row) {
     auto permission = std::make_shared<models::AccessPermission>();
@@ -1,16 +1,35 @@
 #pragma once
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 #include <pqxx/pqxx>
+#include "src/db/connection_pool.hpp"
 #include "src/models/access_permission.hpp"
 #include "src/models/user_role.hpp"
 #include "src/models/user.hpp"
 
 namespace dao {
 
+// Все связи роль-разрешение и пользователь-роль, прочитанные одной транзакцией
+struct AuthorizationRows {
+    struct RolePermission {
+        std::string role_id;
+        std::string role_name;
+        std::optional<std::string> permission_name; // роль без разрешений
+    };
+    struct UserRole {
+        std::string user_id;
+        std::string role_id;
+    };
+
+    std::vector<RolePermission> role_permissions;
+    std::vector<UserRole> user_roles;
+};
+
 class AccessPermissionDAO {
 public:
-    explicit AccessPermissionDAO(std::shared_ptr<pqxx::connection> conn);
+    explicit AccessPermissionDAO(std::shared_ptr<db::ConnectionPool> pool);
     
     bool save(const std::shared_ptr<models::AccessPermission>& permission);
     std::shared_ptr<models::AccessPermission> find_by_id(const std::string& id);
@@ -24,10 +43,12 @@ public:
     bool role_has_permission(const std::string& role_id, const std::string& permission_name);
     std::vector<std::shared_ptr<models::UserRole>> get_roles_with_permission(const std::string& permission_name);
     
-    void initialize_system_permissions();
+
+    // Данные для построения снимка прав в памяти; nullopt при ошибке БД
+    std::optional<AuthorizationRows> load_authorization_rows();
 
 private:
-    std::shared_ptr<pqxx::connection> connection_;
+    std::shared_ptr<db::ConnectionPool> pool_;
     std::shared_ptr<models::AccessPermission> permission_from_row(const pqxx::row& row);
 };
 
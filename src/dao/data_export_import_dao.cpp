@@ -1,67 +1,545 @@
 #include "data_export_import_dao.hpp"
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <pqxx/pqxx>
 #include "log_dao.hpp"
 #include "models/enums.hpp"
+#include "src/db/transaction_scope.hpp"
+#include "src/db/uuid_columns.hpp"
+#include "src/utils/buffered_file_writer.hpp"
+#include "src/utils/csv_reader.hpp"
+#include "src/utils/uuid_generator.hpp"
 
 namespace dao {
 
-DataExportImportDAO::DataExportImportDAO(std::shared_ptr<pqxx::connection> connection)
-    : connection_(std::move(connection)) {}
+namespace {
+// Поле CSV по RFC 4180: в кавычки берутся значения с разделителями, кавычками и переводами строк
+void write_csv_field(utils::BufferedFileWriter& out, std::string_view value) {
+    if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.write(value);
+        return;
+    }
+    out.put('"');
+    for (char c : value) {
+        if (c == '"') {
+            out.put('"');
+        }
+        out.put(c);
+    }
+    out.put('"');
+}
+
+// Результат запроса читается потоком COPY TO STDOUT, без загрузки в память целиком
+size_t stream_csv(pqxx::transaction_base& txn, const std::string& query,
+                  std::string_view header, utils::BufferedFileWriter& out) {
+    out.write(header);
+    out.put('\n');
+
+    size_t rows = 0;
+    auto stream = pqxx::stream_from::query(txn, query);
+    while (auto fields = stream.read_row()) {
+        for (size_t i = 0; i < fields->size(); ++i) {
+            if (i > 0) {
+                out.put(',');
+            }
+            const auto& field = (*fields)[i];
+            // NULL приходит как поле без данных и выгружается пустым
+            if (field.data() != nullptr) {
+                write_csv_field(out, field);
+            }
+        }
+        out.put('\n');
+        ++rows;
+    }
+    stream.complete();
+    return rows;
+}
+
+// Запрос из одного текстового столбца: каждая строка результата - строка файла
+size_t stream_lines(pqxx::transaction_base& txn, const std::string& query,
+                    utils::BufferedFileWriter& out) {
+    size_t rows = 0;
+    auto stream = pqxx::stream_from::query(txn, query);
+    while (auto fields = stream.read_row()) {
+        out.write((*fields)[0]);
+        out.put('\n');
+        ++rows;
+    }
+    stream.complete();
+    return rows;
+}
+
+// --- Импорт ---
+
+enum class Stage { USERS, ROLES, ASSIGNMENTS };
+
+const std::vector<std::string> USER_STAGE_COLUMNS = {
+    "id", "first_name", "last_name", "patronymic", "email", "phone", "password_hash",
+    "is_active", "password_change_required", "created_at", "updated_at", "last_login_at", "roles"};
+const std::vector<std::string> ROLE_STAGE_COLUMNS = {
+    "id", "name", "description", "is_system", "created_at", "updated_at"};
+const std::vector<std::string> ASSIGNMENT_STAGE_COLUMNS = {
+    "user_id", "role_id", "role_name", "assigned_at"};
+
+const std::vector<std::string>& stage_columns(Stage stage) {
+    switch (stage) {
+    case Stage::USERS: return USER_STAGE_COLUMNS;
+    case Stage::ROLES: return ROLE_STAGE_COLUMNS;
+    default: return ASSIGNMENT_STAGE_COLUMNS;
+    }
+}
+
+const char* stage_table(Stage stage) {
+    switch (stage) {
+    case Stage::USERS: return "import_user_stage";
+    case Stage::ROLES: return "import_role_stage";
+    default: return "import_assignment_stage";
+    }
+}
+
+// Идентификатор пользователя получает тип app_user.id, чтобы переноситься без приведений
+void create_stage_tables(pqxx::transaction_base& txn) {
+    const std::string user_id_type = db::user_id_column_type(txn);
+    for (Stage stage : {Stage::USERS, Stage::ROLES, Stage::ASSIGNMENTS}) {
+        std::string sql = std::string("CREATE TEMP TABLE ") + stage_table(stage) + " (";
+        const auto& columns = stage_columns(stage);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            bool user_id = (stage == Stage::USERS && columns[i] == "id") ||
+                           (stage == Stage::ASSIGNMENTS && columns[i] == "user_id");
+            sql += (i > 0 ? ", " : "") + columns[i] + " " + (user_id ? user_id_type : "text");
+        }
+        sql += ") ON COMMIT DROP";
+        txn.exec(sql);
+    }
+}
+
+// Пишет строки во временные таблицы через COPY FROM STDIN. На соединении может
+// быть открыт только один COPY, поэтому при смене таблицы поток переоткрывается.
+class StageWriter {
+public:
+    explicit StageWriter(pqxx::transaction_base& txn) : txn_(txn) {}
+
+    void write(Stage stage, const std::vector<std::optional<std::string>>& row) {
+        if (!stream_ || current_ != stage) {
+            complete();
+            stream_.emplace(pqxx::stream_to::raw_table(txn_, stage_table(stage), column_list(stage)));
+            current_ = stage;
+        }
+        stream_->write_row(row);
+        ++counts_[static_cast<size_t>(stage)];
+    }
+
+    void complete() {
+        if (stream_) {
+            stream_->complete();
+            stream_.reset();
+        }
+    }
+
+    size_t count(Stage stage) const { return counts_[static_cast<size_t>(stage)]; }
+
+private:
+    static std::string column_list(Stage stage) {
+        std::string out;
+        for (const auto& column : stage_columns(stage)) {
+            out += (out.empty() ? "" : ", ") + column;
+        }
+        return out;
+    }
+
+    pqxx::transaction_base& txn_;
+    std::optional<pqxx::stream_to> stream_;
+    Stage current_ = Stage::USERS;
+    size_t counts_[3] = {0, 0, 0};
+};
+
+// Раскладывает значения из столбцов источника по столбцам временной таблицы
+std::vector<std::optional<std::string>> to_stage_row(
+    Stage stage, const std::vector<std::string>& source_columns,
+    std::vector<std::optional<std::string>>& values) {
+    const auto& columns = stage_columns(stage);
+    std::vector<std::optional<std::string>> row(columns.size());
+    for (size_t i = 0; i < source_columns.size() && i < values.size(); ++i) {
+        auto it = std::find(columns.begin(), columns.end(), source_columns[i]);
+        if (it != columns.end()) {
+            row[it - columns.begin()] = std::move(values[i]);
+        }
+    }
+    // Идентификатор пользователя или роли можно не указывать в CSV
+    if (stage != Stage::ASSIGNMENTS && !row[0]) {
+        row[0] = utils::UUIDGenerator::generate_uuid();
+    }
+    return row;
+}
+
+std::optional<Stage> stage_for_table(const std::string& table) {
+    if (table == "app_user") return Stage::USERS;
+    if (table == "user_role") return Stage::ROLES;
+    if (table == "user_role_assignment") return Stage::ASSIGNMENTS;
+    return std::nullopt;
+}
+
+// Вид CSV определяется по заголовку
+std::optional<Stage> stage_for_header(const std::vector<std::string>& header) {
+    auto has = [&](const char* column) {
+        return std::find(header.begin(), header.end(), column) != header.end();
+    };
+    if (has("email")) return Stage::USERS;
+    if (has("user_id") && (has("role_id") || has("role_name"))) return Stage::ASSIGNMENTS;
+    if (has("name") && has("is_system")) return Stage::ROLES;
+    return std::nullopt;
+}
+
+enum class ParseStatus { OK, INCOMPLETE, INVALID };
+
+struct InsertStatement {
+    std::string table;
+    std::vector<std::string> columns;
+    std::vector<std::optional<std::string>> values;
+};
+
+std::string trim(const std::string& value) {
+    size_t begin = value.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t\r\n");
+    return value.substr(begin, end - begin + 1);
+}
+
+std::string to_upper(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return value;
+}
+
+// Разбор строки вида INSERT INTO t (a, b) VALUES ('x', NULL); из export_to_file.
+// Понимает '...' с удвоенными кавычками, E'...' с обратной косой, NULL, TRUE/FALSE и числа.
+ParseStatus parse_insert(const std::string& sql, InsertStatement& out) {
+    const std::string upper = to_upper(sql);
+    size_t pos = upper.find("INSERT INTO");
+    if (pos == std::string::npos) {
+        return ParseStatus::INVALID;
+    }
+    pos += 11;
+
+    size_t open = sql.find('(', pos);
+    size_t close = open == std::string::npos ? open : sql.find(')', open);
+    if (close == std::string::npos) {
+        return ParseStatus::INVALID;
+    }
+    out.table = trim(sql.substr(pos, open - pos));
+    out.columns.clear();
+    std::stringstream column_list(sql.substr(open + 1, close - open - 1));
+    std::string column;
+    while (std::getline(column_list, column, ',')) {
+        out.columns.push_back(trim(column));
+    }
+
+    pos = upper.find("VALUES", close);
+    pos = pos == std::string::npos ? pos : sql.find('(', pos);
+    if (pos == std::string::npos) {
+        return ParseStatus::INVALID;
+    }
+    ++pos;
+
+    out.values.clear();
+    while (true) {
+        while (pos < sql.size() && std::isspace(static_cast<unsigned char>(sql[pos]))) {
+            ++pos;
+        }
+        if (pos >= sql.size()) {
+            return ParseStatus::INCOMPLETE;
+        }
+
+        bool escaped_string = (sql[pos] == 'E' || sql[pos] == 'e') && pos + 1 < sql.size() && sql[pos + 1] == '\'';
+        if (sql[pos] == '\'' || escaped_string) {
+            pos += escaped_string ? 2 : 1;
+            std::string value;
+            bool closed = false;
+            while (pos < sql.size()) {
+                char c = sql[pos++];
+                if (escaped_string && c == '\\' && pos < sql.size()) {
+                    value += sql[pos++];
+                } else if (c == '\'') {
+                    if (pos < sql.size() && sql[pos] == '\'') {
+                        value += '\'';
+                        ++pos;
+                    } else {
+                        closed = true;
+                        break;
+                    }
+                } else {
+                    value += c;
+                }
+            }
+            if (!closed) {
+                return ParseStatus::INCOMPLETE;
+            }
+            out.values.emplace_back(std::move(value));
+        } else {
+            size_t end = sql.find_first_of(",)", pos);
+            if (end == std::string::npos) {
+                return ParseStatus::INCOMPLETE;
+            }
+            std::string token = trim(sql.substr(pos, end - pos));
+            std::string token_upper = to_upper(token);
+            if (token_upper == "NULL") {
+                out.values.emplace_back(std::nullopt);
+            } else if (token_upper == "TRUE" || token_upper == "FALSE") {
+                out.values.emplace_back(token_upper == "TRUE" ? "true" : "false");
+            } else {
+                out.values.emplace_back(token);
+            }
+            pos = end;
+        }
+
+        while (pos < sql.size() && std::isspace(static_cast<unsigned char>(sql[pos]))) {
+            ++pos;
+        }
+        if (pos >= sql.size()) {
+            return ParseStatus::INCOMPLETE;
+        }
+        if (sql[pos] == ')') {
+            break;
+        }
+        if (sql[pos] != ',') {
+            return ParseStatus::INVALID;
+        }
+        ++pos;
+    }
+
+    return out.values.size() == out.columns.size() ? ParseStatus::OK : ParseStatus::INVALID;
+}
+
+void stage_dump(std::istream& in, StageWriter& writer) {
+    std::string line;
+    std::string statement;
+    InsertStatement insert;
+    while (std::getline(in, line)) {
+        if (statement.empty()) {
+            std::string trimmed = trim(line);
+            if (trimmed.empty() || trimmed.rfind("--", 0) == 0) {
+                continue;
+            }
+            statement = line;
+        } else {
+            // Значение с переводом строки продолжается на следующей строке файла
+            statement += '\n' + line;
+        }
+
+        auto status = parse_insert(statement, insert);
+        if (status == ParseStatus::INCOMPLETE) {
+            continue;
+        }
+        if (status == ParseStatus::INVALID) {
+            throw std::runtime_error("Cannot parse statement: " + statement.substr(0, 120));
+        }
+        statement.clear();
+
+        auto stage = stage_for_table(insert.table);
+        if (!stage) {
+            throw std::runtime_error("Unsupported table in import: " + insert.table);
+        }
+        writer.write(*stage, to_stage_row(*stage, insert.columns, insert.values));
+    }
+    if (!trim(statement).empty()) {
+        throw std::runtime_error("Unterminated statement at end of file");
+    }
+}
+
+void stage_csv(std::istream& in, StageWriter& writer) {
+    utils::CsvReader reader(in);
+    std::vector<std::string> header;
+    if (!reader.read_record(header)) {
+        throw std::runtime_error("Empty CSV file");
+    }
+    for (auto& column : header) {
+        column = trim(column);
+    }
+
+    auto stage = stage_for_header(header);
+    if (!stage) {
+        throw std::runtime_error("Unrecognized CSV header");
+    }
+
+    std::vector<std::string> fields;
+    std::vector<std::optional<std::string>> values;
+    while (reader.read_record(fields)) {
+        if (fields.size() == 1 && fields[0].empty()) {
+            continue;
+        }
+        values.clear();
+        // Пустое поле CSV соответствует NULL
+        for (auto& field : fields) {
+            if (field.empty()) {
+                values.emplace_back(std::nullopt);
+            } else {
+                values.emplace_back(std::move(field));
+            }
+        }
+        writer.write(*stage, to_stage_row(*stage, header, values));
+    }
+}
+
+// Формат определяется по первой непустой строке: выгрузка export_to_file или CSV
+bool looks_like_dump(std::istream& in) {
+    std::string line;
+    bool dump = false;
+    while (std::getline(in, line)) {
+        std::string trimmed = trim(line);
+        if (!trimmed.empty()) {
+            dump = trimmed.rfind("--", 0) == 0 || to_upper(trimmed).rfind("INSERT INTO", 0) == 0;
+            break;
+        }
+    }
+    in.clear();
+    in.seekg(0);
+    return dump;
+}
+
+// Слияние выполняется набором запросов по всей временной таблице, а не построчно.
+// Пользователи сопоставляются по email, роли - по имени.
+void merge_users(pqxx::transaction_base& txn, bool merge, ImportResult& result) {
+    if (merge) {
+        result.users_updated = txn.exec(
+            "UPDATE app_user u SET "
+            "first_name = COALESCE(s.first_name, u.first_name), "
+            "last_name = COALESCE(s.last_name, u.last_name), "
+            "patronymic = COALESCE(s.patronymic, u.patronymic), "
+            "phone = COALESCE(s.phone, u.phone), "
+            "password_hash = COALESCE(s.password_hash, u.password_hash), "
+            "is_active = COALESCE(s.is_active::boolean, u.is_active), "
+            "password_change_required = COALESCE(s.password_change_required::boolean, u.password_change_required), "
+            "updated_at = CURRENT_TIMESTAMP "
+            "FROM (SELECT DISTINCT ON (email) * FROM import_user_stage "
+            "      WHERE email IS NOT NULL ORDER BY email) s "
+            "WHERE u.email = s.email").affected_rows();
+    }
+
+    // Без хеша пароля вход невозможен, пока администратор не задаст новый пароль
+    result.users_inserted = txn.exec(
+        "INSERT INTO app_user (id, first_name, last_name, patronymic, email, phone, password_hash, "
+        "is_active, password_change_required, created_at, updated_at, last_login_at) "
+        "SELECT DISTINCT ON (s.email) s.id, COALESCE(s.first_name, ''), COALESCE(s.last_name, ''), "
+        "s.patronymic, s.email, s.phone, COALESCE(s.password_hash, '!'), "
+        "COALESCE(s.is_active::boolean, true), "
+        "s.password_hash IS NULL OR COALESCE(s.password_change_required::boolean, true), "
+        "COALESCE(s.created_at::timestamp, CURRENT_TIMESTAMP), "
+        "COALESCE(s.updated_at::timestamp, CURRENT_TIMESTAMP), s.last_login_at::timestamp "
+        "FROM import_user_stage s WHERE s.email IS NOT NULL ORDER BY s.email "
+        "ON CONFLICT DO NOTHING").affected_rows();
+}
+
+void merge_roles(pqxx::transaction_base& txn, bool merge, ImportResult& result) {
+    if (merge) {
+        result.roles_updated = txn.exec(
+            "UPDATE user_role r SET "
+            "description = COALESCE(s.description, r.description), "
+            "updated_at = CURRENT_TIMESTAMP "
+            "FROM (SELECT DISTINCT ON (name) * FROM import_role_stage "
+            "      WHERE name IS NOT NULL ORDER BY name) s "
+            "WHERE r.name = s.name").affected_rows();
+    }
+
+    result.roles_inserted = txn.exec(
+        "INSERT INTO user_role (id, name, description, is_system, created_at, updated_at) "
+        "SELECT DISTINCT ON (s.name) s.id, s.name, s.description, "
+        "COALESCE(s.is_system::boolean, false), "
+        "COALESCE(s.created_at::timestamp, CURRENT_TIMESTAMP), "
+        "COALESCE(s.updated_at::timestamp, CURRENT_TIMESTAMP) "
+        "FROM import_role_stage s WHERE s.name IS NOT NULL ORDER BY s.name "
+        "ON CONFLICT DO NOTHING").affected_rows();
+}
+
+// Назначения берутся из отдельной таблицы и из столбца roles пользователей.
+// Идентификаторы из файла переводятся в идентификаторы базы: пользователь из файла
+// находится по email (он мог уже существовать под другим id), роль - по имени.
+const char* ASSIGNMENT_SOURCE_SQL =
+    "SELECT user_id, role_id, role_name, assigned_at FROM import_assignment_stage "
+    "UNION ALL "
+    "SELECT s.id, NULL, NULLIF(trim(role_name), ''), NULL "
+    "FROM import_user_stage s, unnest(string_to_array(s.roles, ';')) AS role_name "
+    "WHERE s.roles IS NOT NULL AND trim(role_name) <> ''";
+
+void merge_assignments(pqxx::transaction_base& txn, ImportResult& result) {
+    result.assignments_read = txn.exec(
+        std::string("SELECT count(*) FROM (") + ASSIGNMENT_SOURCE_SQL + ") a").one_field().as<size_t>();
+    if (result.assignments_read == 0) {
+        return;
+    }
+
+    result.assignments_inserted = txn.exec(
+        std::string(
+        "INSERT INTO user_role_assignment (user_id, role_id, assigned_at) "
+        "SELECT DISTINCT ON (user_id, role_id) user_id, role_id, assigned_at FROM ("
+        "  SELECT COALESCE(by_email.id, by_id.id) AS user_id, "
+        "         COALESCE(role_by_name.id, role_by_id.id) AS role_id, "
+        "         COALESCE(a.assigned_at::timestamp, CURRENT_TIMESTAMP) AS assigned_at "
+        "  FROM (") + ASSIGNMENT_SOURCE_SQL + ") a "
+        "  LEFT JOIN import_user_stage su ON su.id = a.user_id "
+        "  LEFT JOIN app_user by_email ON by_email.email = su.email "
+        "  LEFT JOIN app_user by_id ON by_id.id = a.user_id "
+        "  LEFT JOIN import_role_stage sr ON sr.id = a.role_id "
+        "  LEFT JOIN user_role role_by_name ON role_by_name.name = COALESCE(a.role_name, sr.name) "
+        "  LEFT JOIN user_role role_by_id ON role_by_id.id = a.role_id"
+        ") resolved "
+        "WHERE user_id IS NOT NULL AND role_id IS NOT NULL "
+        "ORDER BY user_id, role_id "
+        "ON CONFLICT (user_id, role_id) DO NOTHING").affected_rows();
+}
+} // namespace
+
+DataExportImportDAO::DataExportImportDAO(std::shared_ptr<db::ConnectionPool> pool)
+    : pool_(std::move(pool)) {}
 
 bool DataExportImportDAO::export_to_file(const std::string& file_path) {
     try {
-        pqxx::work txn(*connection_);
-        
-        std::ofstream file(file_path);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
+
+        utils::BufferedFileWriter file(file_path);
         if (!file.is_open()) {
             return false;
         }
 
-        file << "-- Users table data\n";
-        auto users_result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, updated_at, last_login_at "
-            "FROM app_user"
-        );
-        
-        for (const auto& row : users_result) {
-            file << "INSERT INTO app_user (id, first_name, last_name, patronymic, email, phone, "
-                 << "password_hash, is_active, password_change_required, created_at, updated_at, last_login_at) VALUES ("
-                 << "'" << row["id"].as<std::string>() << "', "
-                 << "'" << row["first_name"].as<std::string>() << "', "
-                 << "'" << row["last_name"].as<std::string>() << "', "
-                 << (row["patronymic"].is_null() ? "NULL" : "'" + row["patronymic"].as<std::string>() + "'") << ", "
-                 << "'" << row["email"].as<std::string>() << "', "
-                 << (row["phone"].is_null() ? "NULL" : "'" + row["phone"].as<std::string>() + "'") << ", "
-                 << "'" << row["password_hash"].as<std::string>() << "', "
-                 << row["is_active"].as<bool>() << ", "
-                 << row["password_change_required"].as<bool>() << ", "
-                 << "'" << row["created_at"].as<std::string>() << "', "
-                 << "'" << row["updated_at"].as<std::string>() << "', "
-                 << (row["last_login_at"].is_null() ? "NULL" : "'" + row["last_login_at"].as<std::string>() + "'")
-                 << ");\n";
-        }
+        // Строки INSERT собирает сервер: format('%L') экранирует значения и подставляет NULL
+        file.write("-- Users table data\n");
+        stream_lines(txn,
+            "SELECT format('INSERT INTO app_user (id, first_name, last_name, patronymic, email, phone, "
+            "password_hash, is_active, password_change_required, created_at, updated_at, last_login_at) "
+            "VALUES (%L, %L, %L, %L, %L, %L, %L, %L, %L, %L, %L, %L);', "
+            "id, first_name, last_name, patronymic, email, phone, password_hash, is_active, "
+            "password_change_required, created_at, updated_at, last_login_at) "
+            "FROM app_user ORDER BY created_at",
+            file);
 
-        file << "\n-- Roles table data\n";
-        auto roles_result = txn.exec("SELECT id, name, description, is_system, created_at, updated_at FROM user_role");
-        for (const auto& row : roles_result) {
-            file << "INSERT INTO user_role (id, name, description, is_system, created_at, updated_at) VALUES ("
-                 << "'" << row["id"].as<std::string>() << "', "
-                 << "'" << row["name"].as<std::string>() << "', "
-                 << (row["description"].is_null() ? "NULL" : "'" + row["description"].as<std::string>() + "'") << ", "
-                 << row["is_system"].as<bool>() << ", "
-                 << "'" << row["created_at"].as<std::string>() << "', "
-                 << "'" << row["updated_at"].as<std::string>() << "'"
-                 << ");\n";
-        }
+        file.write("\n-- Roles table data\n");
+        stream_lines(txn,
+            "SELECT format('INSERT INTO user_role (id, name, description, is_system, created_at, updated_at) "
+            "VALUES (%L, %L, %L, %L, %L, %L);', "
+            "id, name, description, is_system, created_at, updated_at) "
+            "FROM user_role ORDER BY name",
+            file);
+
+        file.write("\n-- Role assignments data\n");
+        stream_lines(txn,
+            "SELECT format('INSERT INTO user_role_assignment (user_id, role_id, assigned_at) "
+            "VALUES (%L, %L, %L);', user_id, role_id, assigned_at) "
+            "FROM user_role_assignment ORDER BY user_id, role_id",
+            file);
 
         txn.commit();
-        return true;
+        return file.close();
     } catch (const std::exception& e) {
         std::cerr << "Export failed: " << e.what() << std::endl;
         return false;
@@ -70,42 +548,36 @@ bool DataExportImportDAO::export_to_file(const std::string& file_path) {
 
 bool DataExportImportDAO::export_logs_to_csv(const std::string& file_path, const LogFilter& filter) {
     try {
-        pqxx::work txn(*connection_);
-        std::ofstream file(file_path);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
+        utils::BufferedFileWriter file(file_path);
         
         if (!file.is_open()) {
             std::cerr << "Cannot open file: " << file_path << std::endl;
             return false;
         }
 
-        file << "level,action_type,message,timestamp,actor_id,subject_id,ip_address,user_agent\n";
-
         std::string query = 
             "SELECT level, action_type, message, timestamp, actor_id, subject_id, ip_address, user_agent "
             "FROM system_log";
         
-        std::string where_clause = "";
+        // stream_from не принимает параметры, поэтому значение экранируется через quote
         if (filter.level != models::LogLevel{}) {
-            where_clause += " WHERE level = '" + models::to_string(filter.level) + "'";
+            query += " WHERE level = " + txn.quote(models::to_string(filter.level));
         }
         
-        query += where_clause + " ORDER BY timestamp DESC";
+        query += " ORDER BY timestamp DESC";
 
-        auto result = txn.exec(query);
-        
-        for (const auto& row : result) {
-            file << row["level"].as<std::string>() << ","
-                 << row["action_type"].as<std::string>() << ","
-                 << "\"" << row["message"].as<std::string>() << "\","
-                 << row["timestamp"].as<std::string>() << ","
-                 << (row["actor_id"].is_null() ? "" : row["actor_id"].as<std::string>()) << ","
-                 << (row["subject_id"].is_null() ? "" : row["subject_id"].as<std::string>()) << ","
-                 << (row["ip_address"].is_null() ? "" : row["ip_address"].as<std::string>()) << ","
-                 << (row["user_agent"].is_null() ? "" : row["user_agent"].as<std::string>()) << "\n";
-        }
+        size_t rows = stream_csv(txn, query,
+            "level,action_type,message,timestamp,actor_id,subject_id,ip_address,user_agent", file);
 
         txn.commit();
-        file.close();
+        if (!file.close()) {
+            std::cerr << "Logs export failed: write error on " << file_path << std::endl;
+            return false;
+        }
+        std::cout << "Exported " << rows << " logs" << std::endl;
         return true;
         
     } catch (const std::exception& e) {
@@ -116,41 +588,27 @@ bool DataExportImportDAO::export_logs_to_csv(const std::string& file_path, const
 
 bool DataExportImportDAO::export_users_to_csv(const std::string& file_path) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
         
-        std::string export_sql = 
-            "COPY (" 
-            "SELECT id, first_name, last_name, patronymic, email, phone, is_active, "
-            "password_change_required, created_at, last_login_at "
-            "FROM app_user ORDER BY created_at DESC"
-            ") TO STDOUT WITH CSV HEADER";
-        
-        std::ofstream file(file_path);
-        
-        file << "id,first_name,last_name,patronymic,email,phone,is_active,"
-             << "password_change_required,created_at,last_login_at\n";
+        utils::BufferedFileWriter file(file_path);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open file: " << file_path << std::endl;
+            return false;
+        }
         
-        auto result = txn.exec(
+        // Флаги выгружаются как 1/0, как и раньше
+        stream_csv(txn,
             "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "is_active, password_change_required, created_at, last_login_at "
-            "FROM app_user ORDER BY created_at DESC"
-        );
-        
-        for (const auto& row : result) {
-            file << row["id"].as<std::string>() << ","
-                 << row["first_name"].as<std::string>() << ","
-                 << row["last_name"].as<std::string>() << ","
-                 << (row["patronymic"].is_null() ? "" : row["patronymic"].as<std::string>()) << ","
-                 << row["email"].as<std::string>() << ","
-                 << (row["phone"].is_null() ? "" : row["phone"].as<std::string>()) << ","
-                 << row["is_active"].as<bool>() << ","
-                 << row["password_change_required"].as<bool>() << ","
-                 << row["created_at"].as<std::string>() << ","
-                 << (row["last_login_at"].is_null() ? "" : row["last_login_at"].as<std::string>()) << "\n";
-        }
+            "is_active::int, password_change_required::int, created_at, last_login_at "
+            "FROM app_user ORDER BY created_at DESC",
+            "id,first_name,last_name,patronymic,email,phone,is_active,"
+            "password_change_required,created_at,last_login_at",
+            file);
         
         txn.commit();
-        return true;
+        return file.close();
     } catch (const std::exception& e) {
         std::cerr << "Users export failed: " << e.what() << std::endl;
         return false;
@@ -159,68 +617,86 @@ bool DataExportImportDAO::export_users_to_csv(const std::string& file_path) {
 
 bool DataExportImportDAO::export_roles_to_csv(const std::string& file_path) {
     try {
-        pqxx::work txn(*connection_);
-        
-        std::string export_sql = 
-            "COPY (" 
-            "SELECT id, name, description, is_system, created_at, updated_at "
-            "FROM user_role ORDER BY name"
-            ") TO STDOUT WITH CSV HEADER";
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
         
-        std::ofstream file(file_path);
-        auto result = txn.exec(export_sql);
-        
-        for (const auto& row : result) {
-            file << row["id"].as<std::string>() << ","
-                 << row["name"].as<std::string>() << ","
-                 << (row["description"].is_null() ? "" : row["description"].as<std::string>()) << ","
-                 << row["is_system"].as<bool>() << ","
-                 << row["created_at"].as<std::string>() << ","
-                 << row["updated_at"].as<std::string>() << "\n";
+        utils::BufferedFileWriter file(file_path);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open file: " << file_path << std::endl;
+            return false;
         }
+
+        stream_csv(txn,
+            "SELECT id, name, description, is_system::int, created_at, updated_at "
+            "FROM user_role ORDER BY name",
+            "id,name,description,is_system,created_at,updated_at",
+            file);
         
         txn.commit();
-        return true;
+        return file.close();
     } catch (const std::exception& e) {
         std::cerr << "Roles export failed: " << e.what() << std::endl;
         return false;
     }
 }
 
-bool DataExportImportDAO::import_from_file(const std::string& file_path) {
+ImportResult DataExportImportDAO::import_from_file(const std::string& file_path, const ImportOptions& options) {
+    ImportResult result;
     try {
-        std::ifstream file(file_path);
+        std::ifstream file(file_path, std::ios::binary);
         if (!file.is_open()) {
-            return false;
+            result.error = "Cannot open file: " + file_path;
+            return result;
         }
-        
-        pqxx::work txn(*connection_);
-        std::string line;
-        
-        while (std::getline(file, line)) {
-            if (!line.empty() && line.find("INSERT INTO") != std::string::npos) {
-                txn.exec(line);
-            }
+        bool dump = looks_like_dump(file);
+
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        create_stage_tables(txn);
+
+        StageWriter writer(txn);
+        if (dump) {
+            stage_dump(file, writer);
+        } else {
+            stage_csv(file, writer);
         }
-        
+        writer.complete();
+
+        result.users_read = writer.count(Stage::USERS);
+        result.roles_read = writer.count(Stage::ROLES);
+
+        // Статистика по временным таблицам нужна планировщику для соединений при слиянии
+        txn.exec("ANALYZE import_user_stage, import_role_stage, import_assignment_stage");
+
+        merge_roles(txn, options.merge, result);
+        merge_users(txn, options.merge, result);
+        merge_assignments(txn, result);
+
         txn.commit();
-        return true;
+        result.success = true;
     } catch (const std::exception& e) {
         std::cerr << "Import failed: " << e.what() << std::endl;
-        return false;
+        result = ImportResult{};
+        result.error = e.what();
     }
+    return result;
 }
 
-bool DataExportImportDAO::import_users_from_csv(const std::string& file_path) {
-    return false;
+bool DataExportImportDAO::import_users_from_csv(const std::string& file_path, bool merge) {
+    ImportOptions options;
+    options.merge = merge;
+    return import_from_file(file_path, options).success;
 }
 
 bool DataExportImportDAO::create_backup(const std::string& backup_path) {
     try {
-        std::string host = connection_->hostname();
-        std::string port = connection_->port();
-        std::string dbname = connection_->dbname();
-        std::string user = connection_->username();
+        auto conn = pool_->acquire();
+        std::string host = conn->hostname();
+        std::string port = conn->port();
+        std::string dbname = conn->dbname();
+        std::string user = conn->username();
         std::string password = "password"; 
         
         std::string command = "pg_dump";
@@ -258,10 +734,12 @@ bool DataExportImportDAO::restore_backup(const std::string& backup_path) {
             return false;
         }
         
-        std::string host = connection_->hostname();
-        std::string port = connection_->port();
-        std::string dbname = connection_->dbname();
-        std::string user = connection_->username();
+        auto conn = pool_->acquire();
+        
+        std::string host = conn->hostname();
+        std::string port = conn->port();
+        std::string dbname = conn->dbname();
+        std::string user = conn->username();
         std::string password = "password";
         
         std::string command = "pg_restore";
@@ -295,7 +773,9 @@ bool DataExportImportDAO::restore_backup(const std::string& backup_path) {
 
 size_t DataExportImportDAO::get_user_count() {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
         auto result = txn.exec("SELECT COUNT(*) FROM app_user");
         txn.commit();
         return result[0][0].as<size_t>();
@@ -306,8 +786,11 @@ size_t DataExportImportDAO::get_user_count() {
 
 size_t DataExportImportDAO::get_log_count() {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec("SELECT COUNT(*) FROM system_log");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        // Почасовые счётчики вместо полного сканирования журнала
+        auto result = txn.exec("SELECT COALESCE(SUM(count), 0)::bigint FROM system_log_counts");
         txn.commit();
         return result[0][0].as<size_t>();
     } catch (const std::exception& e) {
@@ -317,7 +800,9 @@ size_t DataExportImportDAO::get_log_count() {
 
 size_t DataExportImportDAO::get_role_count() {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
         auto result = txn.exec("SELECT COUNT(*) FROM user_role");
         txn.commit();
         return result[0][0].as<size_t>();
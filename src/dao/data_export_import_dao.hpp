@@ -3,24 +3,47 @@
 #include <memory>
 #include <string>
 #include <pqxx/pqxx>
+#include "src/db/connection_pool.hpp"
 #include "log_dao.hpp"
 
 namespace dao {
 
+struct ImportOptions {
+    // false: существующие записи пропускаются; true: обновляются данными из файла
+    bool merge = false;
+};
+
+struct ImportResult {
+    bool success = false;
+    std::string error;
+
+    size_t users_read = 0;
+    size_t users_inserted = 0;
+    size_t users_updated = 0;
+    size_t roles_read = 0;
+    size_t roles_inserted = 0;
+    size_t roles_updated = 0;
+    size_t assignments_read = 0;
+    size_t assignments_inserted = 0;
+};
+
 class DataExportImportDAO {
 private:
-    std::shared_ptr<pqxx::connection> connection_;
+    std::shared_ptr<db::ConnectionPool> pool_;
 
 public:
-    explicit DataExportImportDAO(std::shared_ptr<pqxx::connection> connection);
+    explicit DataExportImportDAO(std::shared_ptr<db::ConnectionPool> pool);
     
     bool export_to_file(const std::string& file_path);
     bool export_logs_to_csv(const std::string& file_path, const LogFilter& filter = {});
     bool export_users_to_csv(const std::string& file_path);
     bool export_roles_to_csv(const std::string& file_path);
     
-    bool import_from_file(const std::string& file_path);
-    bool import_users_from_csv(const std::string& file_path);
+    // Принимает SQL-выгрузку export_to_file или CSV с заголовком (пользователи,
+    // роли или назначения ролей). Всё загружается через COPY во временные таблицы
+    // и сливается в основные таблицы одной транзакцией.
+    ImportResult import_from_file(const std::string& file_path, const ImportOptions& options = {});
+    bool import_users_from_csv(const std::string& file_path, bool merge = false);
     
     bool create_backup(const std::string& backup_path);
     bool restore_backup(const std::string& backup_path);
@@ -3,15 +3,198 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 #include <iostream>
 #include "../models/enums.hpp"
 #include "../models/system_log.hpp"
+#include "../db/log_partitions.hpp"
+#include "../db/statement_catalog.hpp"
+#include "../db/server_cursor.hpp"
+#include "../db/transaction_scope.hpp"
+#include "../utils/base64.hpp"
 #include "../utils/uuid_generator.hpp"
 
 namespace dao {
 
-LogDAO::LogDAO(std::shared_ptr<pqxx::connection> conn)
-    : connection_(std::move(conn)) {
+namespace {
+const std::string LOG_COLUMNS =
+    "id, level, action_type, message, timestamp, "
+    "actor_id, subject_id, ip_address, user_agent";
+
+// Дописывает почасовые поправки счётчиков по строкам source (level, action_type,
+// timestamp) со знаком sign. Удаление пишет в час отрицательную поправку, поэтому
+// сумма верна, даже если этот час уже свёрнут в сутки. Это только INSERT в
+// system_log_rollup_delta: транзакция вызывающего не блокирует общие строки
+// счётчиков, их обновляет fold_rollups короткой отдельной транзакцией.
+std::string rollup_delta(const std::string& source, const std::string& sign) {
+    return "INSERT INTO system_log_rollup_delta (bucket, level, action_type, count) "
+           "SELECT date_trunc('hour', timestamp), level, action_type, " + sign + "COUNT(*) "
+           "FROM " + source + " GROUP BY 1, 2, 3";
+}
+
+bool registered = []() {
+    using db::StatementCatalog;
+
+    StatementCatalog::register_statement("log_insert",
+        "WITH inserted AS (INSERT INTO system_log (id, level, action_type, message, "
+        "actor_id, subject_id, ip_address, user_agent) "
+        "VALUES ($1, $2, $3, $4, $5, $6, $7, $8) RETURNING level, action_type, timestamp) " +
+        rollup_delta("inserted", ""));
+    StatementCatalog::register_statement("log_find_by_id",
+        "SELECT " + LOG_COLUMNS + " FROM system_log WHERE id = $1");
+    StatementCatalog::register_statement("log_delete",
+        "WITH deleted AS (DELETE FROM system_log WHERE id = $1 "
+        "RETURNING level, action_type, timestamp) " + rollup_delta("deleted", "-"));
+    StatementCatalog::register_statement("log_find_recent",
+        "SELECT " + LOG_COLUMNS + " FROM system_log ORDER BY timestamp DESC LIMIT $1");
+    StatementCatalog::register_statement("log_find_by_level",
+        "SELECT " + LOG_COLUMNS + " FROM system_log WHERE level = $1 "
+        "ORDER BY timestamp ASC LIMIT $2");
+    StatementCatalog::register_statement("log_find_by_action_type",
+        "SELECT " + LOG_COLUMNS + " FROM system_log WHERE action_type = $1 "
+        "ORDER BY timestamp DESC LIMIT $2");
+    StatementCatalog::register_statement("log_find_by_actor",
+        "SELECT " + LOG_COLUMNS + " FROM system_log WHERE actor_id = $1 "
+        "ORDER BY timestamp DESC LIMIT $2");
+    StatementCatalog::register_statement("log_find_by_subject",
+        "SELECT " + LOG_COLUMNS + " FROM system_log WHERE subject_id = $1 "
+        "ORDER BY timestamp DESC LIMIT $2");
+    StatementCatalog::register_statement("log_find_by_ip_address",
+        "SELECT " + LOG_COLUMNS + " FROM system_log WHERE ip_address = $1 "
+        "ORDER BY timestamp DESC LIMIT $2");
+    // Распределения и общее число читают счётчики вместе с ещё не свёрнутыми
+    // поправками (представление system_log_counts), а не сканируют журнал
+    StatementCatalog::register_statement("log_level_distribution",
+        "SELECT level, SUM(count)::bigint AS count FROM system_log_counts "
+        "GROUP BY level HAVING SUM(count) > 0 ORDER BY 2 DESC");
+    StatementCatalog::register_statement("log_action_type_distribution",
+        "SELECT action_type, SUM(count)::bigint AS count FROM system_log_counts "
+        "GROUP BY action_type HAVING SUM(count) > 0 ORDER BY 2 DESC");
+    // Границы диапазона округляются до корзины; свёрнутые часы видны только посуточно
+    StatementCatalog::register_statement("log_histogram",
+        "SELECT date_trunc($3, bucket)::text AS bucket, SUM(count)::bigint AS count "
+        "FROM system_log_counts "
+        "WHERE bucket >= date_trunc($3, $1::timestamp) AND bucket < $2::timestamp "
+        "GROUP BY 1 HAVING SUM(count) > 0 ORDER BY 1");
+    // Поправки забирает только одна транзакция: параллельная после ожидания не
+    // увидит уже удалённых строк. Ключи обновляются в одном порядке.
+    StatementCatalog::register_statement("log_rollup_fold",
+        "WITH folded AS (DELETE FROM system_log_rollup_delta "
+        "RETURNING bucket, level, action_type, count) "
+        "INSERT INTO system_log_rollup (bucket, granularity, level, action_type, count) "
+        "SELECT bucket, 'hour', level, action_type, SUM(count) "
+        "FROM folded GROUP BY 1, 3, 4 ORDER BY 1, 3, 4 "
+        "ON CONFLICT (bucket, granularity, level, action_type) "
+        "DO UPDATE SET count = system_log_rollup.count + EXCLUDED.count");
+    StatementCatalog::register_statement("log_rollup_compact",
+        "WITH folded AS (DELETE FROM system_log_rollup WHERE granularity = 'hour' "
+        "AND bucket < date_trunc('day', CURRENT_TIMESTAMP::timestamp) - make_interval(days => $1) "
+        "RETURNING bucket, level, action_type, count) "
+        "INSERT INTO system_log_rollup (bucket, granularity, level, action_type, count) "
+        "SELECT date_trunc('day', bucket), 'day', level, action_type, SUM(count) "
+        "FROM folded GROUP BY 1, 3, 4 ORDER BY 1, 3, 4 "
+        "ON CONFLICT (bucket, granularity, level, action_type) "
+        "DO UPDATE SET count = system_log_rollup.count + EXCLUDED.count");
+    StatementCatalog::register_statement("log_rollup_delete_empty",
+        "DELETE FROM system_log_rollup WHERE count = 0");
+    // Секция system_log_pYYYYMM удаляется целиком вместе со счётчиками её месяца
+    StatementCatalog::register_statement("log_rollup_delete_month",
+        "WITH deltas AS (DELETE FROM system_log_rollup_delta WHERE bucket >= to_date($1, 'YYYYMM') "
+        "AND bucket < to_date($1, 'YYYYMM') + interval '1 month') "
+        "DELETE FROM system_log_rollup WHERE bucket >= to_date($1, 'YYYYMM') "
+        "AND bucket < to_date($1, 'YYYYMM') + interval '1 month'");
+    // Сумма по самой таблице и её секциям; reltuples = -1 у ещё не проанализированных
+    StatementCatalog::register_statement("log_estimate_rows",
+        "SELECT COALESCE(SUM(GREATEST(c.reltuples, 0)), 0)::bigint FROM pg_class c "
+        "WHERE c.oid = 'system_log'::regclass "
+        "OR c.oid IN (SELECT inhrelid FROM pg_inherits WHERE inhparent = 'system_log'::regclass)");
+    // Уведомление доставляется подписчикам только после фиксации транзакции
+    StatementCatalog::register_statement("log_notify", "SELECT pg_notify($1, $2)");
+    // Остаток после удаления секций: записи в секции по умолчанию
+    StatementCatalog::register_statement("log_delete_default_before",
+        "WITH deleted AS (DELETE FROM system_log_default WHERE timestamp < $1 "
+        "RETURNING level, action_type, timestamp), "
+        "rollup AS (" + rollup_delta("deleted", "-") + ") "
+        "SELECT COUNT(*) FROM deleted");
+    return true;
+}();
+
+std::vector<std::shared_ptr<models::SystemLog>> logs_from_result(const pqxx::result& result) {
+    std::vector<std::shared_ptr<models::SystemLog>> logs;
+    logs.reserve(result.size());
+    for (const auto& row : result) {
+        auto log = std::make_shared<models::SystemLog>();
+        log->from_row(row);
+        logs.push_back(log);
+    }
+    return logs;
+}
+
+std::optional<std::string> optional_id(const std::string& id) {
+    if (id.empty()) {
+        return std::nullopt;
+    }
+    return id;
+}
+
+std::string placeholder(const pqxx::params& params) {
+    return "$" + std::to_string(params.size());
+}
+
+// Токен продолжения: base64url от "timestamp<US>id" последней строки страницы
+constexpr char CURSOR_SEPARATOR = '\x1f';
+
+std::string encode_cursor(const std::string& timestamp, const std::string& id) {
+    return utils::Base64Url::encode(timestamp + CURSOR_SEPARATOR + id);
+}
+
+// Полезная нагрузка NOTIFY ограничена 8000 байтами: id отправляются порциями
+constexpr size_t NOTIFY_PAYLOAD_LIMIT = 7900;
+
+// inserted - результат INSERT ... RETURNING id: повторы, пропущенные ON CONFLICT, не объявляются
+void notify_inserted(pqxx::transaction_base& txn, const pqxx::result& inserted) {
+    std::string payload;
+    for (const auto& row : inserted) {
+        const std::string id = row[0].as<std::string>();
+        if (!payload.empty() && payload.size() + id.size() + 1 > NOTIFY_PAYLOAD_LIMIT) {
+            txn.exec_prepared("log_notify", LOG_NOTIFY_CHANNEL, payload);
+            payload.clear();
+        }
+        payload += payload.empty() ? id : "," + id;
+    }
+    if (!payload.empty()) {
+        txn.exec_prepared("log_notify", LOG_NOTIFY_CHANNEL, payload);
+    }
+}
+
+std::optional<std::pair<std::string, std::string>> decode_cursor(const std::string& cursor) {
+    auto decoded = utils::Base64Url::decode(cursor);
+    if (!decoded) {
+        return std::nullopt;
+    }
+    size_t separator = decoded->find(CURSOR_SEPARATOR);
+    if (separator == std::string::npos || separator == 0 || separator + 1 == decoded->size()) {
+        return std::nullopt;
+    }
+    return std::make_pair(decoded->substr(0, separator), decoded->substr(separator + 1));
+}
+bool plan_has_seq_scan(const std::string& plan) {
+    return plan.find("\"Node Type\": \"Seq Scan\"") != std::string::npos;
+}
+
+std::string plan_index_name(const std::string& plan) {
+    const std::string key = "\"Index Name\": \"";
+    size_t pos = plan.find(key);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos += key.size();
+    return plan.substr(pos, plan.find('"', pos) - pos);
+}
+} // namespace
+
+LogDAO::LogDAO(std::shared_ptr<db::ConnectionPool> pool)
+    : pool_(std::move(pool)) {
 }
 
 bool LogDAO::save(const std::shared_ptr<models::SystemLog>& log) {
@@ -20,29 +203,20 @@ bool LogDAO::save(const std::shared_ptr<models::SystemLog>& log) {
             log->set_id(utils::UUIDGenerator::generate_uuid());
         }
 
-        pqxx::work txn(*connection_);
-
-        std::string actor_id = log->actor_id().empty() ? "NULL" : txn.quote(log->actor_id());
-        std::string subject_id = log->subject_id().empty() ? "NULL" : txn.quote(log->subject_id());
-        std::string ip_address = log->ip_address().value_or("NULL");
-        std::string user_agent = log->user_agent().value_or("NULL");
-
-        if (ip_address != "NULL") ip_address = txn.quote(ip_address);
-        if (user_agent != "NULL") user_agent = txn.quote(user_agent);
-
-        txn.exec(
-            "INSERT INTO system_log (id, level, action_type, message, "
-            "actor_id, subject_id, ip_address, user_agent) "
-            "VALUES (" +
-            txn.quote(log->id()) + ", " +
-            txn.quote(log->level_string()) + ", " +
-            txn.quote(log->action_type_string()) + ", " +
-            txn.quote(log->message()) + ", " +
-            actor_id + ", " +
-            subject_id + ", " +
-            ip_address + ", " +
-            user_agent + ")"
-        );
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        txn.exec_prepared("log_insert",
+            log->id(),
+            log->level_string(),
+            log->action_type_string(),
+            log->message(),
+            optional_id(log->actor_id()),
+            optional_id(log->subject_id()),
+            log->ip_address(),
+            log->user_agent());
+        txn.exec_prepared("log_notify", LOG_NOTIFY_CHANNEL, log->id());
 
         txn.commit();
         return true;
@@ -52,13 +226,80 @@ bool LogDAO::save(const std::shared_ptr<models::SystemLog>& log) {
     }
 }
 
+bool LogDAO::save_batch(const std::vector<std::shared_ptr<models::SystemLog>>& logs) {
+    if (logs.empty()) {
+        return true;
+    }
+
+    // PostgreSQL ограничивает число параметров запроса 65535
+    constexpr size_t ROWS_PER_STATEMENT = 1000;
+
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        for (size_t offset = 0; offset < logs.size(); offset += ROWS_PER_STATEMENT) {
+            size_t end = std::min(logs.size(), offset + ROWS_PER_STATEMENT);
+            pqxx::params params;
+            std::string sql =
+                "INSERT INTO system_log (id, level, action_type, message, timestamp, "
+                "actor_id, subject_id, ip_address, user_agent) VALUES ";
+
+            for (size_t i = offset; i < end; ++i) {
+                const auto& log = logs[i];
+                if (log->id().empty()) {
+                    log->set_id(utils::UUIDGenerator::generate_uuid());
+                }
+                std::optional<std::string> timestamp;
+                if (!log->timestamp().empty()) {
+                    timestamp = log->timestamp();
+                }
+
+                params.append(log->id());
+                sql += (i == offset ? "(" : ", (") + placeholder(params);
+                params.append(log->level_string());
+                sql += ", " + placeholder(params);
+                params.append(log->action_type_string());
+                sql += ", " + placeholder(params);
+                params.append(log->message());
+                sql += ", " + placeholder(params);
+                // Время события фиксируется при постановке в очередь, а не при записи
+                params.append(timestamp);
+                sql += ", COALESCE(" + placeholder(params) + "::timestamptz, CURRENT_TIMESTAMP)";
+                params.append(optional_id(log->actor_id()));
+                sql += ", " + placeholder(params);
+                params.append(optional_id(log->subject_id()));
+                sql += ", " + placeholder(params);
+                params.append(log->ip_address());
+                sql += ", " + placeholder(params);
+                params.append(log->user_agent());
+                sql += ", " + placeholder(params) + ")";
+            }
+
+            // Первичный ключ секционированной таблицы включает timestamp; повтор из
+            // файла переполнения несёт то же время, что и исходная запись
+            sql += " ON CONFLICT (id, timestamp) DO NOTHING "
+                   "RETURNING id, level, action_type, timestamp";
+            sql = "WITH inserted AS (" + sql + "), rollup AS (" + rollup_delta("inserted", "") + ") "
+                  "SELECT id FROM inserted";
+            notify_inserted(txn, txn.exec_params(sql, params));
+        }
+
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::save_batch: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 std::shared_ptr<models::SystemLog> LogDAO::find_by_id(const std::string& id) {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, level, action_type, message, timestamp, "
-            "actor_id, subject_id, ip_address, user_agent "
-            "FROM system_log WHERE id = " + txn.quote(id));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_by_id", id);
 
         txn.commit();
 
@@ -77,8 +318,10 @@ std::shared_ptr<models::SystemLog> LogDAO::find_by_id(const std::string& id) {
 
 bool LogDAO::remove(const std::shared_ptr<models::SystemLog>& log) {
     try {
-        pqxx::work txn(*connection_);
-        txn.exec("DELETE FROM system_log WHERE id = " + txn.quote(log->id()));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        txn.exec_prepared("log_delete", log->id());
         txn.commit();
         return true;
     } catch (const std::exception& e) {
@@ -91,19 +334,14 @@ std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_recent_logs(size_t
     std::vector<std::shared_ptr<models::SystemLog>> logs;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, level, action_type, message, timestamp, "
-            "actor_id, subject_id, ip_address, user_agent "
-            "FROM system_log ORDER BY timestamp DESC LIMIT " + std::to_string(limit));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_recent", limit);
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto log = std::make_shared<models::SystemLog>();
-            log->from_row(row);
-            logs.push_back(log);
-        }
+        logs = logs_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::find_recent_logs: " << e.what() << std::endl;
     }
@@ -111,73 +349,332 @@ std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_recent_logs(size_t
     return logs;
 }
 
+models::SystemLogBatch LogDAO::find_recent_logs_batch(size_t limit) {
+    models::SystemLogBatch logs;
+
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_recent", limit);
+
+        txn.commit();
+
+        logs.append(result);
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::find_recent_logs_batch: " << e.what() << std::endl;
+    }
+
+    return logs;
+}
+
+models::SystemLogBatch LogDAO::find_by_ids_batch(const std::vector<std::string>& ids, const LogFilter& filter) {
+    models::SystemLogBatch logs;
+    if (ids.empty()) {
+        return logs;
+    }
+
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::AUTOCOMMIT);
+        auto& txn = txn_scope.get();
+
+        pqxx::params params;
+        std::string where_clause = build_filter_condition(filter, params);
+        params.append(ids);
+        std::string id_condition = "id = ANY(" + placeholder(params) + ")";
+        where_clause = where_clause.empty() ? id_condition : where_clause + " AND " + id_condition;
+
+        auto result = txn.exec_params(
+            "SELECT " + LOG_COLUMNS + " FROM system_log WHERE " + where_clause +
+            " ORDER BY timestamp ASC, id ASC", params);
+
+        txn.commit();
+
+        logs.append(result);
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::find_by_ids_batch: " << e.what() << std::endl;
+    }
+
+    return logs;
+}
+
+bool LogDAO::for_each_log(const LogFilter& filter,
+                          const std::function<bool(const models::SystemLogView&)>& callback,
+                          size_t batch_size) {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
+
+        pqxx::params params;
+        std::string where_clause = build_filter_condition(filter, params);
+        std::string sql = "SELECT " + LOG_COLUMNS + " FROM system_log";
+        if (!where_clause.empty()) {
+            sql += " WHERE " + where_clause;
+        }
+        sql += " ORDER BY timestamp ASC, id ASC";
+
+        db::for_each_batch(txn, "log_scan", sql, params, batch_size,
+            [&callback](const pqxx::result& rows) {
+                // Арена порции освобождается перед чтением следующей
+                models::SystemLogBatch logs;
+                logs.append(rows);
+                for (const auto& log : logs) {
+                    if (!callback(log)) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::for_each_log: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 LogQueryResult LogDAO::find_by_filter(const LogFilter& filter, const Pagination& pagination) {
     LogQueryResult result;
+    if (auto rows = query_page(filter, pagination, result, "find_by_filter")) {
+        result.logs = logs_from_result(*rows);
+        if (result.logs.size() > pagination.page_size) {
+            result.logs.pop_back();
+        }
+    }
+    return result;
+}
+
+LogBatchQueryResult LogDAO::find_by_filter_batch(const LogFilter& filter, const Pagination& pagination) {
+    LogBatchQueryResult result;
+    if (auto rows = query_page(filter, pagination, result, "find_by_filter_batch")) {
+        result.logs.append(*rows);
+        if (result.logs.size() > pagination.page_size) {
+            result.logs.pop_back();
+        }
+    }
+    return result;
+}
 
+std::optional<pqxx::result> LogDAO::query_page(const LogFilter& filter, const Pagination& pagination,
+                                               LogPageInfo& page, const char* caller) {
     try {
-        pqxx::work txn(*connection_);
+        std::optional<std::pair<std::string, std::string>> after;
+        if (!pagination.cursor.empty()) {
+            after = decode_cursor(pagination.cursor);
+            if (!after) {
+                std::cerr << "Error in LogDAO::" << caller << ": invalid cursor" << std::endl;
+                return std::nullopt;
+            }
+        }
+
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        pqxx::params params;
+        std::string where_clause = build_filter_condition(filter, params);
+
+        // Общее количество считается только по запросу: COUNT(*) сканирует все подходящие строки
+        if (pagination.count_mode == CountMode::EXACT) {
+            std::string count_sql = "SELECT COUNT(*) FROM system_log";
+            if (!where_clause.empty()) {
+                count_sql += " WHERE " + where_clause;
+            }
+            page.total_count = txn.exec_params(count_sql, params)[0][0].as<size_t>();
+        } else if (pagination.count_mode == CountMode::ESTIMATE) {
+            page.total_count = estimate_count(txn, where_clause, params);
+            page.total_is_estimate = true;
+        }
+
+        if (after) {
+            params.append(after->first);
+            std::string timestamp_param = placeholder(params);
+            params.append(after->second);
+            std::string key_condition =
+                "(timestamp, id) > (" + timestamp_param + "::timestamp, " + placeholder(params) + ")";
+            where_clause = where_clause.empty() ? key_condition : where_clause + " AND " + key_condition;
+        }
 
-        std::string where_clause = build_filter_condition(filter);
-        std::string sql = "SELECT id, level, action_type, message, timestamp, "
-                         "actor_id, subject_id, ip_address, user_agent "
-                         "FROM system_log";
+        std::string sql = "SELECT " + LOG_COLUMNS + " FROM system_log";
 
         if (!where_clause.empty()) {
             sql += " WHERE " + where_clause;
         }
 
-        sql += " ORDER BY timestamp ASC "
-               "LIMIT " + std::to_string(pagination.page_size) +
-               " OFFSET " + std::to_string(pagination.offset());
+        // Лишняя строка показывает, есть ли следующая страница
+        params.append(pagination.page_size + 1);
+        sql += " ORDER BY timestamp ASC, id ASC LIMIT " + placeholder(params);
+        if (!after && pagination.offset() > 0) {
+            params.append(pagination.offset());
+            sql += " OFFSET " + placeholder(params);
+        }
 
-        auto query_result = txn.exec(sql);
+        auto query_result = txn.exec_params(sql, params);
 
-        // Получаем общее количество для пагинации
-        std::string count_sql = "SELECT COUNT(*) FROM system_log";
-        if (!where_clause.empty()) {
-            count_sql += " WHERE " + where_clause;
+        txn.commit();
+
+        if (query_result.size() > pagination.page_size && pagination.page_size > 0) {
+            const auto last = query_result[pagination.page_size - 1];
+            page.next_cursor = encode_cursor(last["timestamp"].as<std::string>(), last["id"].as<std::string>());
         }
 
-        auto count_result = txn.exec(count_sql);
-        size_t total_count = count_result[0][0].as<size_t>();
+        if (pagination.count_mode != CountMode::NONE && pagination.page_size > 0) {
+            page.total_pages = (page.total_count + pagination.page_size - 1) / pagination.page_size;
+        }
+
+        return query_result;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::" << caller << ": " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+std::vector<IndexUsage> LogDAO::check_index_usage() {
+    std::vector<IndexUsage> report;
+
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
+
+        // Каждый EXECUTE планируется заново, поэтому видит enable_seqscan ниже
+        txn.exec("SET LOCAL plan_cache_mode = force_custom_plan");
+
+        // Значение, которого нет в журнале, допустимо и для VARCHAR, и для uuid
+        const std::string id = txn.quote(std::string("00000000-0000-7000-8000-000000000000"));
+        const std::string level = txn.quote(models::to_string(models::LogLevel::ERROR));
+        const std::string action = txn.quote(models::to_string(models::ActionType::USER_CREATED));
+        const std::vector<std::pair<std::string, std::string>> probes = {
+            {"log_find_by_id", "EXECUTE log_find_by_id(" + id + ")"},
+            {"log_find_recent", "EXECUTE log_find_recent(100)"},
+            {"log_find_by_level", "EXECUTE log_find_by_level(" + level + ", 100)"},
+            {"log_find_by_action_type", "EXECUTE log_find_by_action_type(" + action + ", 100)"},
+            {"log_find_by_actor", "EXECUTE log_find_by_actor(" + id + ", 100)"},
+            {"log_find_by_subject", "EXECUTE log_find_by_subject(" + id + ", 100)"},
+            {"log_find_by_ip_address", "EXECUTE log_find_by_ip_address('127.0.0.1', 100)"},
+            {"find_by_filter (time range)",
+             "SELECT " + LOG_COLUMNS + " FROM system_log "
+             "WHERE timestamp BETWEEN CURRENT_TIMESTAMP::timestamp - interval '1 day' "
+             "AND CURRENT_TIMESTAMP::timestamp ORDER BY timestamp ASC, id ASC LIMIT 51"},
+            {"search_messages",
+             "SELECT " + LOG_COLUMNS + " FROM system_log "
+             "WHERE message_tsv @@ websearch_to_tsquery('simple', 'admin')"},
+        };
+
+        for (const auto& [name, sql] : probes) {
+            auto plan = txn.exec("EXPLAIN (FORMAT JSON) " + sql)[0][0].as<std::string>();
+            IndexUsage usage;
+            usage.query = name;
+            usage.uses_index = !plan_has_seq_scan(plan);
+            usage.index_name = plan_index_name(plan);
+            report.push_back(usage);
+        }
+
+        txn.exec("SET LOCAL enable_seqscan = off");
+        for (size_t i = 0; i < probes.size(); ++i) {
+            auto plan = txn.exec("EXPLAIN (FORMAT JSON) " + probes[i].second)[0][0].as<std::string>();
+            report[i].index_available = !plan_has_seq_scan(plan);
+            if (report[i].index_name.empty()) {
+                report[i].index_name = plan_index_name(plan);
+            }
+        }
 
         txn.commit();
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::check_index_usage: " << e.what() << std::endl;
+    }
+
+    return report;
+}
+
+std::unique_ptr<pqxx::connection> LogDAO::open_listener_connection() {
+    return std::make_unique<pqxx::connection>(pool_->connection_string());
+}
+
+// Без фильтра берётся reltuples из статистики, иначе - оценка строк из плана запроса
+size_t LogDAO::estimate_count(pqxx::transaction_base& txn, const std::string& where_clause,
+                              const pqxx::params& params) {
+    if (where_clause.empty()) {
+        auto result = txn.exec_prepared("log_estimate_rows");
+        return result[0][0].as<size_t>();
+    }
 
-        // Заполняем результат
-        for (const auto& row : query_result) {
-            auto log = std::make_shared<models::SystemLog>();
-            log->from_row(row);
-            result.logs.push_back(log);
+    auto plan = txn.exec_params(
+        "EXPLAIN (FORMAT JSON) SELECT 1 FROM system_log WHERE " + where_clause, params);
+    const std::string json = plan[0][0].as<std::string>();
+    const std::string key = "\"Plan Rows\":";
+    size_t pos = json.find(key);
+    if (pos == std::string::npos) {
+        return 0;
+    }
+    return static_cast<size_t>(std::stod(json.substr(pos + key.size())));
+}
+
+std::vector<LogSearchHit> LogDAO::search_messages(const std::string& query, const LogFilter& filter,
+                                                  size_t limit) {
+    std::vector<LogSearchHit> hits;
+    if (query.empty()) {
+        return hits;
+    }
+
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::AUTOCOMMIT);
+        auto& txn = txn_scope.get();
+
+        pqxx::params params;
+        params.append(query);
+        const std::string ts_query = "websearch_to_tsquery('simple', " + placeholder(params) + ")";
+        std::string where_clause = "message_tsv @@ " + ts_query;
+        std::string filter_condition = build_filter_condition(filter, params);
+        if (!filter_condition.empty()) {
+            where_clause += " AND " + filter_condition;
         }
+        params.append(limit);
+
+        // ts_headline перечитывает текст сообщения, поэтому считается только для строк после LIMIT
+        auto result = txn.exec_params(
+            "SELECT " + LOG_COLUMNS + ", rank, "
+            "ts_headline('simple', message, " + ts_query + ", "
+            "'StartSel=[, StopSel=], MaxWords=20, MinWords=5, MaxFragments=2') AS snippet "
+            "FROM (SELECT " + LOG_COLUMNS + ", ts_rank(message_tsv, " + ts_query + ") AS rank "
+            "      FROM system_log WHERE " + where_clause +
+            "      ORDER BY rank DESC, timestamp DESC LIMIT " + placeholder(params) + ") ranked "
+            "ORDER BY rank DESC, timestamp DESC", params);
 
-        result.total_count = total_count;
-        result.total_pages = (total_count + pagination.page_size - 1) / pagination.page_size;
+        txn.commit();
 
+        hits.reserve(result.size());
+        for (const auto& row : result) {
+            LogSearchHit hit;
+            hit.log = std::make_shared<models::SystemLog>();
+            hit.log->from_row(row);
+            hit.rank = row["rank"].as<double>();
+            hit.snippet = row["snippet"].as<std::string>();
+            hits.push_back(std::move(hit));
+        }
     } catch (const std::exception& e) {
-        std::cerr << "Error in LogDAO::find_by_filter: " << e.what() << std::endl;
+        std::cerr << "Error in LogDAO::search_messages: " << e.what() << std::endl;
     }
 
-    return result;
+    return hits;
 }
 
 std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_by_level(models::LogLevel level, size_t limit) {
     std::vector<std::shared_ptr<models::SystemLog>> logs;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, level, action_type, message, timestamp, "
-            "actor_id, subject_id, ip_address, user_agent "
-            "FROM system_log WHERE level = " + txn.quote(models::to_string(level)) +
-            " ORDER BY timestamp ASC LIMIT " + std::to_string(limit));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_by_level", models::to_string(level), limit);
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto log = std::make_shared<models::SystemLog>();
-            log->from_row(row);
-            logs.push_back(log);
-        }
+        logs = logs_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::find_by_level: " << e.what() << std::endl;
     }
@@ -189,20 +686,14 @@ std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_by_action_type(mode
     std::vector<std::shared_ptr<models::SystemLog>> logs;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, level, action_type, message, timestamp, "
-            "actor_id, subject_id, ip_address, user_agent "
-            "FROM system_log WHERE action_type = " + txn.quote(models::to_string(action_type)) +
-            " ORDER BY timestamp DESC LIMIT " + std::to_string(limit));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_by_action_type", models::to_string(action_type), limit);
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto log = std::make_shared<models::SystemLog>();
-            log->from_row(row);
-            logs.push_back(log);
-        }
+        logs = logs_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::find_by_action_type: " << e.what() << std::endl;
     }
@@ -214,20 +705,14 @@ std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_by_actor(const std:
     std::vector<std::shared_ptr<models::SystemLog>> logs;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, level, action_type, message, timestamp, "
-            "actor_id, subject_id, ip_address, user_agent "
-            "FROM system_log WHERE actor_id = " + txn.quote(actor_id) +
-            " ORDER BY timestamp DESC LIMIT " + std::to_string(limit));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_by_actor", actor_id, limit);
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto log = std::make_shared<models::SystemLog>();
-            log->from_row(row);
-            logs.push_back(log);
-        }
+        logs = logs_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::find_by_actor: " << e.what() << std::endl;
     }
@@ -239,20 +724,14 @@ std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_by_subject(const st
     std::vector<std::shared_ptr<models::SystemLog>> logs;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, level, action_type, message, timestamp, "
-            "actor_id, subject_id, ip_address, user_agent "
-            "FROM system_log WHERE subject_id = " + txn.quote(subject_id) +
-            " ORDER BY timestamp DESC LIMIT " + std::to_string(limit));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_by_subject", subject_id, limit);
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto log = std::make_shared<models::SystemLog>();
-            log->from_row(row);
-            logs.push_back(log);
-        }
+        logs = logs_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::find_by_subject: " << e.what() << std::endl;
     }
@@ -264,20 +743,14 @@ std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_by_ip_address(const
     std::vector<std::shared_ptr<models::SystemLog>> logs;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, level, action_type, message, timestamp, "
-            "actor_id, subject_id, ip_address, user_agent "
-            "FROM system_log WHERE ip_address = " + txn.quote(ip_address) +
-            " ORDER BY timestamp DESC LIMIT " + std::to_string(limit));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_find_by_ip_address", ip_address, limit);
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto log = std::make_shared<models::SystemLog>();
-            log->from_row(row);
-            logs.push_back(log);
-        }
+        logs = logs_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::find_by_ip_address: " << e.what() << std::endl;
     }
@@ -287,16 +760,25 @@ std::vector<std::shared_ptr<models::SystemLog>> LogDAO::find_by_ip_address(const
 
 size_t LogDAO::get_log_count(const LogFilter& filter) {
     try {
-        pqxx::work txn(*connection_);
-
-        std::string where_clause = build_filter_condition(filter);
-        std::string sql = "SELECT COUNT(*) FROM system_log";
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        pqxx::params params;
+        std::string where_clause = build_filter_condition(filter, params);
+        // Фильтр только по уровню и типу действия считается по почасовым счётчикам
+        bool by_rollup = filter.actor_id.empty() && filter.subject_id.empty() &&
+                         filter.message_pattern.empty() && filter.ip_address.empty() &&
+                         filter.search_query.empty() && !filter.has_time_range();
+        std::string sql = by_rollup
+            ? "SELECT COALESCE(SUM(count), 0)::bigint FROM system_log_counts"
+            : "SELECT COUNT(*) FROM system_log";
 
         if (!where_clause.empty()) {
             sql += " WHERE " + where_clause;
         }
 
-        auto result = txn.exec(sql);
+        auto result = txn.exec_params(sql, params);
         txn.commit();
 
         return result[0][0].as<size_t>();
@@ -310,10 +792,10 @@ std::vector<std::pair<models::LogLevel, size_t>> LogDAO::get_log_level_distribut
     std::vector<std::pair<models::LogLevel, size_t>> distribution;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT level, COUNT(*) FROM system_log "
-            "GROUP BY level ORDER BY COUNT(*) DESC");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_level_distribution");
 
         txn.commit();
 
@@ -334,10 +816,10 @@ std::vector<std::pair<models::ActionType, size_t>> LogDAO::get_action_type_distr
     std::vector<std::pair<models::ActionType, size_t>> distribution;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT action_type, COUNT(*) FROM system_log "
-            "GROUP BY action_type ORDER BY COUNT(*) DESC");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_action_type_distribution");
 
         txn.commit();
 
@@ -354,17 +836,89 @@ std::vector<std::pair<models::ActionType, size_t>> LogDAO::get_action_type_distr
     return distribution;
 }
 
+std::vector<std::pair<std::string, size_t>> LogDAO::get_log_histogram(
+    const std::chrono::system_clock::time_point& start,
+    const std::chrono::system_clock::time_point& end,
+    const std::string& granularity) {
+    std::vector<std::pair<std::string, size_t>> histogram;
+
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::AUTOCOMMIT);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("log_histogram",
+            time_point_to_sql(start), time_point_to_sql(end), granularity);
+
+        txn.commit();
+
+        for (const auto& row : result) {
+            histogram.emplace_back(row["bucket"].as<std::string>(), row["count"].as<size_t>());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::get_log_histogram: " << e.what() << std::endl;
+    }
+
+    return histogram;
+}
+
+bool LogDAO::fold_rollups() {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        txn.exec_prepared("log_rollup_fold");
+
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::fold_rollups: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool LogDAO::compact_rollups(int keep_hourly_days) {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        txn.exec_prepared("log_rollup_fold");
+        auto folded = txn.exec_prepared("log_rollup_compact", keep_hourly_days);
+        txn.exec_prepared("log_rollup_delete_empty");
+
+        txn.commit();
+
+        if (folded.affected_rows() > 0) {
+            std::cout << "Compacted log rollups into " << folded.affected_rows() << " daily buckets" << std::endl;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::compact_rollups: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// Удаляются целые месячные секции, поэтому хранение округляется до месяца:
+// записи остаются, пока не устареет весь их месяц
 bool LogDAO::cleanup_old_logs(const std::chrono::system_clock::time_point& before) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
         std::string timestamp = time_point_to_sql(before);
-        auto result = txn.exec(
-            "DELETE FROM system_log WHERE timestamp < " + txn.quote(timestamp));
+        auto dropped = db::drop_log_partitions_before(txn, timestamp);
+        for (const auto& name : dropped) {
+            txn.exec_prepared("log_rollup_delete_month", name.substr(std::string("system_log_p").size()));
+        }
+        auto deleted = txn.exec_prepared("log_delete_default_before", timestamp)[0][0].as<size_t>();
+        db::ensure_log_partitions(txn);
 
         txn.commit();
 
-        std::cout << "Cleaned up " << result.affected_rows() << " old logs" << std::endl;
+        std::cout << "Dropped " << dropped.size() << " old log partitions, cleaned up "
+                  << deleted << " old logs" << std::endl;
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::cleanup_old_logs: " << e.what() << std::endl;
@@ -372,22 +926,49 @@ bool LogDAO::cleanup_old_logs(const std::chrono::system_clock::time_point& befor
     }
 }
 
+bool LogDAO::ensure_partitions(int months_ahead) {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        auto created = db::ensure_log_partitions(txn, months_ahead);
+
+        txn.commit();
+
+        if (!created.empty()) {
+            std::cout << "Created " << created.size() << " log partitions" << std::endl;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in LogDAO::ensure_partitions: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 bool LogDAO::delete_logs_by_filter(const LogFilter& filter) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
-        std::string where_clause = build_filter_condition(filter);
+        pqxx::params params;
+        std::string where_clause = build_filter_condition(filter, params);
         if (where_clause.empty()) {
             std::cerr << "Warning: Attempt to delete all logs without filter" << std::endl;
             return false;
         }
 
-        std::string sql = "DELETE FROM system_log WHERE " + where_clause;
-        auto result = txn.exec(sql);
+        std::string sql =
+            "WITH deleted AS (DELETE FROM system_log WHERE " + where_clause +
+            " RETURNING level, action_type, timestamp), "
+            "rollup AS (" + rollup_delta("deleted", "-") + ") "
+            "SELECT COUNT(*) FROM deleted";
+        auto result = txn.exec_params(sql, params);
 
         txn.commit();
 
-        std::cout << "Deleted " << result.affected_rows() << " logs by filter" << std::endl;
+        std::cout << "Deleted " << result[0][0].as<size_t>() << " logs by filter" << std::endl;
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in LogDAO::delete_logs_by_filter: " << e.what() << std::endl;
@@ -396,37 +977,58 @@ bool LogDAO::delete_logs_by_filter(const LogFilter& filter) {
 }
 
 // Вспомогательные методы
-std::string LogDAO::build_filter_condition(const LogFilter& filter) {
+std::string LogDAO::build_filter_condition(const LogFilter& filter, pqxx::params& params) {
     std::vector<std::string> conditions;
 
     if (filter.level != models::LogLevel{}) {
-        conditions.push_back("level = '" + models::to_string(filter.level) + "'");
+        params.append(models::to_string(filter.level));
+        conditions.push_back("level = " + placeholder(params));
     }
 
     if (filter.action_type != models::ActionType{}) {
-        conditions.push_back("action_type = '" + models::to_string(filter.action_type) + "'");
+        params.append(models::to_string(filter.action_type));
+        conditions.push_back("action_type = " + placeholder(params));
     }
 
     if (!filter.actor_id.empty()) {
-        conditions.push_back("actor_id = '" + filter.actor_id + "'");
+        params.append(filter.actor_id);
+        conditions.push_back("actor_id = " + placeholder(params));
     }
 
     if (!filter.subject_id.empty()) {
-        conditions.push_back("subject_id = '" + filter.subject_id + "'");
+        params.append(filter.subject_id);
+        conditions.push_back("subject_id = " + placeholder(params));
     }
 
     if (!filter.message_pattern.empty()) {
-        conditions.push_back("message ILIKE '%" + filter.message_pattern + "%'");
+        // Экранируем % и _ из пользовательского ввода, чтобы искать подстроку буквально
+        std::string escaped;
+        for (char c : filter.message_pattern) {
+            if (c == '%' || c == '_' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        params.append("%" + escaped + "%");
+        conditions.push_back("message ILIKE " + placeholder(params));
+    }
+
+    if (!filter.search_query.empty()) {
+        params.append(filter.search_query);
+        conditions.push_back("message_tsv @@ websearch_to_tsquery('simple', " + placeholder(params) + ")");
     }
 
     if (!filter.ip_address.empty()) {
-        conditions.push_back("ip_address = '" + filter.ip_address + "'");
+        params.append(filter.ip_address);
+        conditions.push_back("ip_address = " + placeholder(params));
     }
 
+    // Типизированные границы позволяют отсечь лишние секции журнала
     if (filter.has_time_range()) {
-        std::string start_time = time_point_to_sql(filter.start_time);
-        std::string end_time = time_point_to_sql(filter.end_time);
-        conditions.push_back("timestamp BETWEEN '" + start_time + "' AND '" + end_time + "'");
+        params.append(time_point_to_sql(filter.start_time));
+        std::string start_param = placeholder(params) + "::timestamp";
+        params.append(time_point_to_sql(filter.end_time));
+        conditions.push_back("timestamp BETWEEN " + start_param + " AND " + placeholder(params) + "::timestamp");
     }
 
     if (conditions.empty()) {
@@ -1,22 +1,34 @@
 #pragma once
+#include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <string>
 #include <chrono>
 #include <pqxx/pqxx>
+#include "../db/connection_pool.hpp"
+#include "../db/log_partitions.hpp"
 #include "../models/system_log.hpp"
+#include "../models/system_log_batch.hpp"
 #include "../models/enums.hpp"
-#include "log_dao.hpp"
 #include <iostream>
 
 namespace dao {
 
+// Канал NOTIFY, в который после вставки уходят id новых записей через запятую
+constexpr const char* LOG_NOTIFY_CHANNEL = "system_log_inserted";
+
+// Сколько суток почасовые счётчики журнала хранятся до свёртки в сутки
+constexpr int LOG_ROLLUP_HOURLY_DAYS = 2;
+
 struct LogFilter {
     models::LogLevel level{};
     models::ActionType action_type{};
     std::string actor_id;
     std::string subject_id;
     std::string message_pattern;
+    // Поисковый запрос в синтаксисе websearch_to_tsquery: слова, "фраза", -исключение, or
+    std::string search_query;
     std::string ip_address;
     std::chrono::system_clock::time_point start_time{};
     std::chrono::system_clock::time_point end_time{};
@@ -27,50 +39,129 @@ struct LogFilter {
     }
 };
 
+// Как считать общее число записей для страницы
+enum class CountMode {
+    NONE,     // не считать
+    ESTIMATE, // оценка планировщика или статистики таблицы, без сканирования
+    EXACT     // SELECT COUNT(*) по фильтру
+};
+
 struct Pagination {
     size_t page = 1;
     size_t page_size = 50;
+    // Токен продолжения из LogQueryResult::next_cursor. Если задан, страница
+    // выбирается по ключу (timestamp, id), а page не используется.
+    std::string cursor;
+    CountMode count_mode = CountMode::NONE;
     
     size_t offset() const { return (page - 1) * page_size; }
 };
 
-struct LogQueryResult {
-    std::vector<std::shared_ptr<models::SystemLog>> logs;
+// Запись, найденная по тексту сообщения, с релевантностью и фрагментом, где
+// совпавшие слова выделены [ ]
+struct LogSearchHit {
+    std::shared_ptr<models::SystemLog> log;
+    double rank = 0;
+    std::string snippet;
+};
+
+// План одного запроса журнала для команды check-indexes
+struct IndexUsage {
+    std::string query;
+    // План на текущих данных обходится без последовательного чтения
+    bool uses_index = false;
+    // Индекс применим, если запретить последовательное чтение: на маленькой
+    // таблице планировщик может честно предпочесть Seq Scan
+    bool index_available = false;
+    std::string index_name;
+};
+
+struct LogPageInfo {
     size_t total_count = 0;
     size_t total_pages = 0;
+    bool total_is_estimate = false;
+    // Пустой, если страница последняя
+    std::string next_cursor;
+};
+
+struct LogQueryResult : LogPageInfo {
+    std::vector<std::shared_ptr<models::SystemLog>> logs;
+};
+
+// Та же страница без shared_ptr на запись: строки всех записей в одной арене
+struct LogBatchQueryResult : LogPageInfo {
+    models::SystemLogBatch logs;
 };
 
 class LogDAO {
 public:
-    explicit LogDAO(std::shared_ptr<pqxx::connection> conn);
+    explicit LogDAO(std::shared_ptr<db::ConnectionPool> pool);
     
     // операции с логами
     bool save(const std::shared_ptr<models::SystemLog>& log);
+    // Пакетная вставка одной транзакцией; повторная вставка того же id игнорируется
+    bool save_batch(const std::vector<std::shared_ptr<models::SystemLog>>& logs);
     std::shared_ptr<models::SystemLog> find_by_id(const std::string& id);
     bool remove(const std::shared_ptr<models::SystemLog>& log);
     
     // методы запросов
     std::vector<std::shared_ptr<models::SystemLog>> find_recent_logs(size_t limit = 100);
     LogQueryResult find_by_filter(const LogFilter& filter, const Pagination& pagination = {});
+    // Варианты для больших выборок: непрерывный вектор и строки в арене результата
+    models::SystemLogBatch find_recent_logs_batch(size_t limit = 100);
+    // Записи из списка id, подходящие под фильтр, по возрастанию времени (для LogFollower)
+    models::SystemLogBatch find_by_ids_batch(const std::vector<std::string>& ids, const LogFilter& filter);
+    LogBatchQueryResult find_by_filter_batch(const LogFilter& filter, const Pagination& pagination = {});
+    // Все записи под фильтром по возрастанию времени, серверным курсором порциями по
+    // batch_size. callback получает записи по мере чтения и возвращает false, чтобы
+    // остановить обход. Возвращает false при ошибке БД.
+    bool for_each_log(const LogFilter& filter,
+                      const std::function<bool(const models::SystemLogView&)>& callback,
+                      size_t batch_size = 1000);
     std::vector<std::shared_ptr<models::SystemLog>> find_by_level(models::LogLevel level, size_t limit = 100);
     std::vector<std::shared_ptr<models::SystemLog>> find_by_action_type(models::ActionType action_type, size_t limit = 100);
     std::vector<std::shared_ptr<models::SystemLog>> find_by_actor(const std::string& actor_id, size_t limit = 100);
     std::vector<std::shared_ptr<models::SystemLog>> find_by_subject(const std::string& subject_id, size_t limit = 100);
     std::vector<std::shared_ptr<models::SystemLog>> find_by_ip_address(const std::string& ip_address, size_t limit = 100);
+    // Поиск по индексу message_tsv, самые релевантные первыми; filter сужает выборку
+    std::vector<LogSearchHit> search_messages(const std::string& query, const LogFilter& filter = {},
+                                              size_t limit = 50);
     
     // статистика
     size_t get_log_count(const LogFilter& filter = {});
     std::vector<std::pair<models::LogLevel, size_t>> get_log_level_distribution();
     std::vector<std::pair<models::ActionType, size_t>> get_action_type_distribution();
+    // Число записей по корзинам granularity ("hour" или "day") из system_log_counts
+    std::vector<std::pair<std::string, size_t>> get_log_histogram(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end,
+        const std::string& granularity = "hour");
+    // Переносит накопленные поправки из system_log_rollup_delta в счётчики
+    bool fold_rollups();
+    // То же, затем сворачивает почасовые счётчики старше keep_hourly_days суток в посуточные
+    bool compact_rollups(int keep_hourly_days = LOG_ROLLUP_HOURLY_DAYS);
     
     // очистка логов
     bool cleanup_old_logs(const std::chrono::system_clock::time_point& before);
+    // EXPLAIN запросов find_by_*, постраничной выборки и поиска
+    std::vector<IndexUsage> check_index_usage();
+
+    // Отдельное соединение вне пула для LISTEN: подписка живёт, пока открыто соединение
+    std::unique_ptr<pqxx::connection> open_listener_connection();
+
+    // Создаёт секции журнала на months_ahead месяцев вперёд
+    bool ensure_partitions(int months_ahead = db::LOG_PARTITIONS_AHEAD);
     bool delete_logs_by_filter(const LogFilter& filter);
 
 private:
-    std::shared_ptr<pqxx::connection> connection_;
+    std::shared_ptr<db::ConnectionPool> pool_;
     
-    std::string build_filter_condition(const LogFilter& filter);
+    // Строки страницы без преобразования; заполняет page (счётчики и next_cursor)
+    std::optional<pqxx::result> query_page(const LogFilter& filter, const Pagination& pagination,
+                                           LogPageInfo& page, const char* caller);
+    std::string build_filter_condition(const LogFilter& filter, pqxx::params& params);
+    size_t estimate_count(pqxx::transaction_base& txn, const std::string& where_clause,
+                          const pqxx::params& params);
     std::string time_point_to_sql(const std::chrono::system_clock::time_point& tp);
 };
 
@@ -0,0 +1,77 @@
+#include "revocation_dao.hpp"
+#include <iostream>
+#include "../db/statement_catalog.hpp"
+#include "../db/transaction_scope.hpp"
+
+namespace dao {
+
+namespace {
+bool registered = []() {
+    using db::StatementCatalog;
+
+    StatementCatalog::register_statement("revocation_upsert",
+        "INSERT INTO revoked_subject (subject_id, reason) VALUES ($1, $2) "
+        "ON CONFLICT (subject_id) DO UPDATE SET "
+        "seq = nextval('revoked_subject_seq'), revoked_at = now(), reason = EXCLUDED.reason "
+        "RETURNING seq, subject_id, EXTRACT(EPOCH FROM revoked_at)::bigint");
+    StatementCatalog::register_statement("revocation_load_since",
+        "SELECT seq, subject_id, EXTRACT(EPOCH FROM revoked_at)::bigint "
+        "FROM revoked_subject WHERE seq > $1 ORDER BY seq");
+    StatementCatalog::register_statement("revocation_notify", "SELECT pg_notify($1, $2::text)");
+    return true;
+}();
+
+RevocationEntry entry_from_row(const pqxx::row& row) {
+    return {row[0].as<int64_t>(), row[1].as<std::string>(), row[2].as<int64_t>()};
+}
+} // namespace
+
+RevocationDAO::RevocationDAO(std::shared_ptr<db::ConnectionPool> pool) : pool_(std::move(pool)) {}
+
+std::optional<RevocationEntry> RevocationDAO::revoke(const std::string& subject_id, const std::string& reason) {
+    try {
+        // Отзыв фиксируется сразу, вне пакетной транзакции: иначе блокировка таблицы
+        // держалась бы до фиксации всей группы. Если пакет потом откатится, токены
+        // останутся отозванными - это безопасная сторона.
+        auto conn = pool_->acquire_outside_batch();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        // Блокировка держится до фиксации: следующий отзыв получит seq только после
+        // того, как этот станет виден, и refresh по seq > last_seq его не пропустит.
+        // Чтение (load_since) она не блокирует.
+        txn.exec("LOCK TABLE revoked_subject IN SHARE ROW EXCLUSIVE MODE");
+        auto row = txn.exec_prepared1("revocation_upsert", subject_id, reason);
+        auto entry = entry_from_row(row);
+        // Уведомление доставляется подписчикам при фиксации
+        txn.exec_prepared("revocation_notify", REVOCATION_NOTIFY_CHANNEL, entry.seq);
+        txn.commit();
+        return entry;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in RevocationDAO::revoke: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+std::optional<std::vector<RevocationEntry>> RevocationDAO::load_since(int64_t after_seq) {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::AUTOCOMMIT);
+        auto& txn = txn_scope.get();
+
+        std::vector<RevocationEntry> entries;
+        for (const auto& row : txn.exec_prepared("revocation_load_since", after_seq)) {
+            entries.push_back(entry_from_row(row));
+        }
+        return entries;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in RevocationDAO::load_since: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+std::unique_ptr<pqxx::connection> RevocationDAO::open_listener_connection() {
+    return std::make_unique<pqxx::connection>(pool_->connection_string());
+}
+
+} // namespace dao
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+#include "src/db/connection_pool.hpp"
+
+namespace dao {
+
+// Канал NOTIFY о новых отзывах; полезная нагрузка - seq записи
+constexpr const char* REVOCATION_NOTIFY_CHANNEL = "subject_revoked";
+
+// Строка revoked_subject: токены субъекта, выданные не позже revoked_at, недействительны.
+// seq растёт при каждом отзыве и позволяет дочитывать только новые записи: отзывы
+// выполняются по одному под блокировкой таблицы, поэтому порядок seq совпадает с
+// порядком фиксации и запись с меньшим seq не появится после прочитанной.
+struct RevocationEntry {
+    int64_t seq = 0;
+    std::string subject_id;
+    int64_t revoked_at = 0; // секунды Unix
+};
+
+class RevocationDAO {
+public:
+    explicit RevocationDAO(std::shared_ptr<db::ConnectionPool> pool);
+
+    // Повторный отзыв того же субъекта обновляет его строку; фиксируется в своей
+    // транзакции и внутри BatchTransaction. nullopt при ошибке БД
+    std::optional<RevocationEntry> revoke(const std::string& subject_id, const std::string& reason);
+    // Записи с seq больше after_seq по возрастанию seq; nullopt при ошибке БД
+    std::optional<std::vector<RevocationEntry>> load_since(int64_t after_seq);
+    // Отдельное соединение вне пула для LISTEN на REVOCATION_NOTIFY_CHANNEL
+    std::unique_ptr<pqxx::connection> open_listener_connection();
+
+private:
+    std::shared_ptr<db::ConnectionPool> pool_;
+};
+
+} // namespace dao
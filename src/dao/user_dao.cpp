@@ -1,33 +1,218 @@
 #include "user_dao.hpp"
 #include <algorithm>
+#include <cctype>
 #include <random>
 #include <sstream>
+#include <unordered_set>
 #include <iostream>
+#include "../db/statement_catalog.hpp"
+#include "../db/server_cursor.hpp"
+#include "../db/transaction_scope.hpp"
+#include "../db/uuid_columns.hpp"
 #include "../utils/uuid_generator.hpp"
 
 namespace dao {
 
-UserDAO::UserDAO(std::shared_ptr<pqxx::connection> conn)
-    : connection_(std::move(conn)) {
+namespace {
+const std::string USER_COLUMNS =
+    "id, first_name, last_name, patronymic, email, phone, "
+    "password_hash, is_active, password_change_required, created_at, "
+    "updated_at, last_login_at";
+// Столбцы UserBatch: без хэша пароля
+const std::string USER_VIEW_COLUMNS =
+    "id, first_name, last_name, patronymic, email, phone, is_active, "
+    "password_change_required, created_at, updated_at, last_login_at";
+
+bool registered = []() {
+    using db::StatementCatalog;
+
+    StatementCatalog::register_statement("user_find_all",
+        "SELECT " + USER_COLUMNS + " FROM app_user ORDER BY created_at DESC");
+    StatementCatalog::register_statement("user_find_all_view",
+        "SELECT " + USER_VIEW_COLUMNS + " FROM app_user ORDER BY created_at DESC");
+    StatementCatalog::register_statement("user_find_requiring_password_change",
+        "SELECT " + USER_COLUMNS + " FROM app_user "
+        "WHERE password_change_required = true AND is_active = true "
+        "ORDER BY created_at DESC");
+    StatementCatalog::register_statement("user_find_active",
+        "SELECT " + USER_COLUMNS + " FROM app_user "
+        "WHERE is_active = true ORDER BY created_at DESC");
+    StatementCatalog::register_statement("user_find_by_id",
+        "SELECT " + USER_COLUMNS + " FROM app_user WHERE id = $1");
+    StatementCatalog::register_statement("user_find_by_email",
+        "SELECT " + USER_COLUMNS + " FROM app_user WHERE email = $1");
+    StatementCatalog::register_statement("user_find_by_credentials",
+        "SELECT " + USER_COLUMNS + " FROM app_user "
+        "WHERE email = $1 AND password_hash = $2 AND is_active = true");
+    StatementCatalog::register_statement("user_find_by_name",
+        "SELECT " + USER_COLUMNS + " FROM app_user "
+        "WHERE first_name ILIKE $1 AND last_name ILIKE $2 "
+        "ORDER BY first_name, last_name");
+    StatementCatalog::register_statement("user_insert",
+        "INSERT INTO app_user (id, first_name, last_name, patronymic, email, "
+        "phone, password_hash, is_active, password_change_required) "
+        "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9)");
+    StatementCatalog::register_statement("user_update",
+        "UPDATE app_user SET first_name = $2, last_name = $3, patronymic = $4, "
+        "email = $5, phone = $6, password_hash = $7, is_active = $8, "
+        "password_change_required = $9, updated_at = CURRENT_TIMESTAMP "
+        "WHERE id = $1");
+    StatementCatalog::register_statement("user_delete_role_assignments",
+        "DELETE FROM user_role_assignment WHERE user_id = $1");
+    StatementCatalog::register_statement("user_delete",
+        "DELETE FROM app_user WHERE id = $1");
+    StatementCatalog::register_statement("user_roles",
+        "SELECT ur.id, ur.name, ur.description, ur.is_system, ur.created_at, ur.updated_at "
+        "FROM user_role ur "
+        "INNER JOIN user_role_assignment ura ON ur.id = ura.role_id "
+        "WHERE ura.user_id = $1");
+    StatementCatalog::register_statement("user_assign_role",
+        "INSERT INTO user_role_assignment (user_id, role_id) VALUES ($1, $2) "
+        "ON CONFLICT (user_id, role_id) DO NOTHING");
+    StatementCatalog::register_statement("user_remove_role",
+        "DELETE FROM user_role_assignment WHERE user_id = $1 AND role_id = $2");
+    StatementCatalog::register_statement("user_has_role",
+        "SELECT EXISTS ("
+        "SELECT 1 FROM user_role_assignment ura "
+        "INNER JOIN user_role ur ON ura.role_id = ur.id "
+        "WHERE ura.user_id = $1 AND ur.name = $2)");
+    StatementCatalog::register_statement("user_update_last_login",
+        "UPDATE app_user SET last_login_at = CURRENT_TIMESTAMP WHERE id = $1 "
+        "RETURNING last_login_at");
+    // Роли и разрешения склеиваются через chr(31) - символ, которого нет в именах
+    StatementCatalog::register_statement("user_login_profile",
+        "SELECT " + USER_COLUMNS + ", "
+        "(SELECT string_agg(ur.name, chr(31) ORDER BY ur.name) "
+        " FROM user_role_assignment ura JOIN user_role ur ON ur.id = ura.role_id "
+        " WHERE ura.user_id = app_user.id) AS role_names, "
+        "(SELECT string_agg(DISTINCT ap.name, chr(31)) "
+        " FROM user_role_assignment ura "
+        " JOIN role_permission rp ON rp.role_id = ura.role_id "
+        " JOIN access_permission ap ON ap.id = rp.permission_id "
+        " WHERE ura.user_id = app_user.id) AS permission_names "
+        "FROM app_user WHERE email = $1");
+    StatementCatalog::register_statement("user_record_login",
+        "UPDATE app_user SET last_login_at = CURRENT_TIMESTAMP "
+        "WHERE id = $1 AND password_hash = $2 AND is_active = true "
+        "RETURNING last_login_at");
+    StatementCatalog::register_statement("user_change_password",
+        "UPDATE app_user SET password_hash = $2, password_change_required = false, "
+        "updated_at = CURRENT_TIMESTAMP WHERE id = $1");
+    StatementCatalog::register_statement("user_set_active",
+        "UPDATE app_user SET is_active = $2, updated_at = CURRENT_TIMESTAMP WHERE id = $1");
+    StatementCatalog::register_statement("role_find_by_name",
+        "SELECT id, name, description, is_system, created_at, updated_at "
+        "FROM user_role WHERE name = $1");
+    return true;
+}();
+
+std::vector<std::string> split_names(const pqxx::field& field) {
+    std::vector<std::string> names;
+    if (field.is_null()) {
+        return names;
+    }
+    std::string value = field.as<std::string>();
+    size_t start = 0;
+    while (true) {
+        size_t end = value.find('\x1f', start);
+        names.push_back(value.substr(start, end - start));
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return names;
+}
+
+std::vector<std::shared_ptr<models::User>> users_from_result(const pqxx::result& result) {
+    std::vector<std::shared_ptr<models::User>> users;
+    users.reserve(result.size());
+    for (const auto& row : result) {
+        auto user = std::make_shared<models::User>();
+        user->from_row(row);
+        users.push_back(user);
+    }
+    return users;
+}
+} // namespace
+
+UserDAO::UserDAO(std::shared_ptr<db::ConnectionPool> pool, UserCacheConfig cache_config)
+    : pool_(std::move(pool)),
+      cache_config_(cache_config),
+      users_by_id_(cache_config.capacity, cache_config.shards),
+      users_by_email_(cache_config.capacity, cache_config.shards) {
+}
+
+std::string UserDAO::email_key(const std::string& email) {
+    std::string key = email;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+// Инвалидация увеличивает поколение до erase, поэтому повторная проверка после put
+// ловит запись, которая могла сделать erase между первой проверкой и put
+void UserDAO::cache_user(const std::shared_ptr<const models::User>& user, uint64_t generation) {
+    if (cache_config_.capacity == 0 || cache_generation_.load() != generation) {
+        return;
+    }
+    std::string key = email_key(user->email());
+    users_by_id_.put(user->id(), user, cache_config_.ttl);
+    users_by_email_.put(key, CachedEmail{user, user->email()}, cache_config_.ttl);
+    if (cache_generation_.load() != generation) {
+        users_by_id_.erase(user->id());
+        users_by_email_.erase(key);
+    }
+}
+
+void UserDAO::cache_missing_email(const std::string& email, uint64_t generation) {
+    if (cache_config_.capacity == 0 || cache_generation_.load() != generation) {
+        return;
+    }
+    std::string key = email_key(email);
+    users_by_email_.put(key, CachedEmail{nullptr, email}, cache_config_.negative_ttl);
+    if (cache_generation_.load() != generation) {
+        users_by_email_.erase(key);
+    }
+}
+
+void UserDAO::invalidate(const std::string& id, const std::string& email) {
+    ++cache_generation_;
+    // Email мог измениться: старый адрес берётся из записи по id
+    if (auto cached = users_by_id_.get(id)) {
+        users_by_email_.erase(email_key((*cached)->email()));
+    }
+    users_by_id_.erase(id);
+    users_by_email_.erase(email_key(email));
+}
+
+UserCacheStats UserDAO::cache_stats() const {
+    UserCacheStats stats;
+    stats.hits = cache_hits_.load();
+    stats.negative_hits = cache_negative_hits_.load();
+    stats.misses = cache_misses_.load();
+    stats.entries = users_by_id_.size();
+    return stats;
+}
+
+void UserDAO::clear_cache() {
+    ++cache_generation_;
+    users_by_id_.clear();
+    users_by_email_.clear();
 }
 
 std::vector<std::shared_ptr<models::User>> UserDAO::find_all() {
     std::vector<std::shared_ptr<models::User>> users;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, "
-            "updated_at, last_login_at FROM app_user ORDER BY created_at DESC");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_all");
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto user = std::make_shared<models::User>();
-            user->from_row(row);
-            users.push_back(user);
-        }
+        users = users_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in find_all: " << e.what() << std::endl;
     }
@@ -35,25 +220,71 @@ std::vector<std::shared_ptr<models::User>> UserDAO::find_all() {
     return users;
 }
 
+models::UserBatch UserDAO::find_all_batch() {
+    models::UserBatch users;
+
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_all_view");
+
+        txn.commit();
+
+        users.append(result);
+    } catch (const std::exception& e) {
+        std::cerr << "Error in find_all_batch: " << e.what() << std::endl;
+    }
+
+    return users;
+}
+
+bool UserDAO::for_each_user(const std::function<bool(const models::UserView&)>& callback,
+                            bool active_only, size_t batch_size) {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::READ_ONLY);
+        auto& txn = txn_scope.get();
+
+        std::string sql = "SELECT " + USER_VIEW_COLUMNS + " FROM app_user";
+        if (active_only) {
+            sql += " WHERE is_active = true";
+        }
+        sql += " ORDER BY created_at DESC";
+
+        db::for_each_batch(txn, "user_scan", sql, pqxx::params{}, batch_size,
+            [&callback](const pqxx::result& rows) {
+                // Арена порции освобождается перед чтением следующей
+                models::UserBatch users;
+                users.append(rows);
+                for (const auto& user : users) {
+                    if (!callback(user)) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+
+        txn.commit();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in for_each_user: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 std::vector<std::shared_ptr<models::User>> UserDAO::find_users_requiring_password_change() {
     std::vector<std::shared_ptr<models::User>> users;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, "
-            "updated_at, last_login_at FROM app_user "
-            "WHERE password_change_required = true AND is_active = true "
-            "ORDER BY created_at DESC");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_requiring_password_change");
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto user = std::make_shared<models::User>();
-            user->from_row(row);
-            users.push_back(user);
-        }
+        users = users_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in find_users_requiring_password_change: " << e.what() << std::endl;
     }
@@ -65,20 +296,14 @@ std::vector<std::shared_ptr<models::User>> UserDAO::find_active_users() {
     std::vector<std::shared_ptr<models::User>> users;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, "
-            "updated_at, last_login_at FROM app_user "
-            "WHERE is_active = true ORDER BY created_at DESC");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_active");
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto user = std::make_shared<models::User>();
-            user->from_row(row);
-            users.push_back(user);
-        }
+        users = users_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in find_active_users: " << e.what() << std::endl;
     }
@@ -87,12 +312,18 @@ std::vector<std::shared_ptr<models::User>> UserDAO::find_active_users() {
 }
 
 std::shared_ptr<models::User> UserDAO::find_by_id(const std::string& id) {
+    if (auto cached = users_by_id_.get(id)) {
+        ++cache_hits_;
+        return std::make_shared<models::User>(**cached);
+    }
+    ++cache_misses_;
+
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, "
-            "updated_at, last_login_at FROM app_user WHERE id = " + txn.quote(id));
+        uint64_t generation = cache_generation_.load();
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_by_id", id);
 
         txn.commit();
 
@@ -102,6 +333,7 @@ std::shared_ptr<models::User> UserDAO::find_by_id(const std::string& id) {
 
         auto user = std::make_shared<models::User>();
         user->from_row(result[0]);
+        cache_user(std::make_shared<const models::User>(*user), generation);
         return user;
     } catch (const std::exception& e) {
         std::cerr << "Error in find_by_id: " << e.what() << std::endl;
@@ -109,22 +341,36 @@ std::shared_ptr<models::User> UserDAO::find_by_id(const std::string& id) {
     }
 }
 
+// Ключ кэша - email в нижнем регистре, но сравнение в базе точное,
+// поэтому запись используется только при совпадении написания
 std::shared_ptr<models::User> UserDAO::find_by_email(const std::string& email) {
+    if (auto cached = users_by_email_.get(email_key(email)); cached && cached->email == email) {
+        if (!cached->user) {
+            ++cache_negative_hits_;
+            return nullptr;
+        }
+        ++cache_hits_;
+        return std::make_shared<models::User>(*cached->user);
+    }
+    ++cache_misses_;
+
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, "
-            "updated_at, last_login_at FROM app_user WHERE email = " + txn.quote(email));
+        uint64_t generation = cache_generation_.load();
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_by_email", email);
 
         txn.commit();
 
         if (result.empty()) {
+            cache_missing_email(email, generation);
             return nullptr;
         }
 
         auto user = std::make_shared<models::User>();
         user->from_row(result[0]);
+        cache_user(std::make_shared<const models::User>(*user), generation);
         return user;
     } catch (const std::exception& e) {
         std::cerr << "Error in find_by_email: " << e.what() << std::endl;
@@ -134,14 +380,10 @@ std::shared_ptr<models::User> UserDAO::find_by_email(const std::string& email) {
 
 std::shared_ptr<models::User> UserDAO::find_by_credentials(const std::string& email, const std::string& password_hash) {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, "
-            "updated_at, last_login_at FROM app_user "
-            "WHERE email = " + txn.quote(email) +
-            " AND password_hash = " + txn.quote(password_hash) +
-            " AND is_active = true");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_by_credentials", email, password_hash);
 
         txn.commit();
 
@@ -164,26 +406,24 @@ bool UserDAO::save(const std::shared_ptr<models::User>& user) {
             user->set_id(utils::UUIDGenerator::generate_uuid());
         }
 
-        pqxx::work txn(*connection_);
-
-        std::string patronymic = user->patronymic().value_or("");
-        std::string phone = user->phone().value_or("");
-
-        txn.exec(
-            "INSERT INTO app_user (id, first_name, last_name, patronymic, email, "
-            "phone, password_hash, is_active, password_change_required) "
-            "VALUES (" +
-            txn.quote(user->id()) + ", " +
-            txn.quote(user->first_name()) + ", " +
-            txn.quote(user->last_name()) + ", " +
-            txn.quote(patronymic) + ", " +
-            txn.quote(user->email()) + ", " +
-            txn.quote(phone) + ", " +
-            txn.quote(user->password_hash()) + ", " +
-            txn.quote(user->is_active()) + ", " +
-            txn.quote(user->is_password_change_required()) + ")");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        txn.exec_prepared("user_insert",
+            user->id(),
+            user->first_name(),
+            user->last_name(),
+            user->patronymic(),
+            user->email(),
+            user->phone(),
+            user->password_hash(),
+            user->is_active(),
+            user->is_password_change_required());
 
         txn.commit();
+        // Снимает отрицательную запись для этого email
+        invalidate(user->id(), user->email());
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in save: " << e.what() << std::endl;
@@ -191,26 +431,91 @@ bool UserDAO::save(const std::shared_ptr<models::User>& user) {
     }
 }
 
-bool UserDAO::update(const std::shared_ptr<models::User>& user) {
+std::optional<std::vector<bool>> UserDAO::save_bulk(const std::vector<std::shared_ptr<models::User>>& users,
+                                                    const std::vector<std::vector<std::string>>& role_ids) {
     try {
-        pqxx::work txn(*connection_);
-
-        std::string patronymic = user->patronymic().value_or("");
-        std::string phone = user->phone().value_or("");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        const std::string id_type = db::user_id_column_type(txn);
+        txn.exec("CREATE TEMP TABLE bulk_user_stage (id " + id_type + ", first_name text, last_name text, "
+                 "email text, password_hash text) ON COMMIT DROP");
+        txn.exec("CREATE TEMP TABLE bulk_role_stage (user_id " + id_type + ", role_id text) ON COMMIT DROP");
+
+        // На соединении может быть открыт только один COPY
+        {
+            auto stream = pqxx::stream_to::raw_table(txn, "bulk_user_stage",
+                                                     "id, first_name, last_name, email, password_hash");
+            for (const auto& user : users) {
+                if (user->id().empty()) {
+                    user->set_id(utils::UUIDGenerator::generate_uuid());
+                }
+                stream.write_values(user->id(), user->first_name(), user->last_name(),
+                                    user->email(), user->password_hash());
+            }
+            stream.complete();
+        }
+        {
+            auto stream = pqxx::stream_to::raw_table(txn, "bulk_role_stage", "user_id, role_id");
+            for (size_t i = 0; i < users.size() && i < role_ids.size(); ++i) {
+                for (const auto& role_id : role_ids[i]) {
+                    stream.write_values(users[i]->id(), role_id);
+                }
+            }
+            stream.complete();
+        }
 
+        auto inserted_rows = txn.exec(
+            "INSERT INTO app_user (id, first_name, last_name, email, password_hash, "
+            "is_active, password_change_required) "
+            "SELECT id, first_name, last_name, email, password_hash, true, true "
+            "FROM bulk_user_stage ON CONFLICT DO NOTHING RETURNING id");
+        // id новые, поэтому в app_user есть только что вставленные пользователи
         txn.exec(
-            "UPDATE app_user SET first_name = " + txn.quote(user->first_name()) +
-            ", last_name = " + txn.quote(user->last_name()) +
-            ", patronymic = " + txn.quote(patronymic) +
-            ", email = " + txn.quote(user->email()) +
-            ", phone = " + txn.quote(phone) +
-            ", password_hash = " + txn.quote(user->password_hash()) +
-            ", is_active = " + txn.quote(user->is_active()) +
-            ", password_change_required = " + txn.quote(user->is_password_change_required()) +
-            ", updated_at = CURRENT_TIMESTAMP " +
-            "WHERE id = " + txn.quote(user->id()));
+            "INSERT INTO user_role_assignment (user_id, role_id) "
+            "SELECT DISTINCT s.user_id, s.role_id FROM bulk_role_stage s "
+            "JOIN app_user u ON u.id = s.user_id "
+            "ON CONFLICT (user_id, role_id) DO NOTHING");
+        txn.commit();
+
+        std::unordered_set<std::string> inserted_ids;
+        for (const auto& row : inserted_rows) {
+            inserted_ids.insert(row[0].as<std::string>());
+        }
+        std::vector<bool> inserted(users.size(), false);
+        for (size_t i = 0; i < users.size(); ++i) {
+            inserted[i] = inserted_ids.count(users[i]->id()) > 0;
+            if (inserted[i]) {
+                invalidate(users[i]->id(), users[i]->email());
+            }
+        }
+        return inserted;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in save_bulk: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+bool UserDAO::update(const std::shared_ptr<models::User>& user) {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+
+        txn.exec_prepared("user_update",
+            user->id(),
+            user->first_name(),
+            user->last_name(),
+            user->patronymic(),
+            user->email(),
+            user->phone(),
+            user->password_hash(),
+            user->is_active(),
+            user->is_password_change_required());
 
         txn.commit();
+        invalidate(user->id(), user->email());
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in update: " << e.what() << std::endl;
@@ -220,15 +525,18 @@ bool UserDAO::update(const std::shared_ptr<models::User>& user) {
 
 bool UserDAO::delete_by_id(const std::string& id) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
         // Сначала удаляем связи с ролями
-        txn.exec("DELETE FROM user_role_assignment WHERE user_id = " + txn.quote(id));
+        txn.exec_prepared("user_delete_role_assignments", id);
 
         // Затем удаляем пользователя
-        txn.exec("DELETE FROM app_user WHERE id = " + txn.quote(id));
+        txn.exec_prepared("user_delete", id);
 
         txn.commit();
+        invalidate(id, "");
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in delete_by_id: " << e.what() << std::endl;
@@ -240,12 +548,10 @@ std::vector<std::shared_ptr<models::UserRole>> UserDAO::user_roles(const std::sh
     std::vector<std::shared_ptr<models::UserRole>> roles;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT ur.id, ur.name, ur.description, ur.is_system, ur.created_at, ur.updated_at "
-            "FROM user_role ur "
-            "INNER JOIN user_role_assignment ura ON ur.id = ura.role_id "
-            "WHERE ura.user_id = " + txn.quote(user->id()));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_roles", user->id());
 
         txn.commit();
 
@@ -263,16 +569,12 @@ std::vector<std::shared_ptr<models::UserRole>> UserDAO::user_roles(const std::sh
 
 bool UserDAO::assign_role(const std::shared_ptr<models::User>& user, const std::shared_ptr<models::UserRole>& role) {
     try {
-        // Проверяем, не назначена ли уже эта роль
-        if (has_role(user, role->name())) {
-            return true; // Роль уже назначена
-        }
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
-        pqxx::work txn(*connection_);
-
-        txn.exec(
-            "INSERT INTO user_role_assignment (user_id, role_id) VALUES (" +
-            txn.quote(user->id()) + ", " + txn.quote(role->id()) + ")");
+        // Повторное назначение роли игнорируется через ON CONFLICT
+        txn.exec_prepared("user_assign_role", user->id(), role->id());
 
         txn.commit();
         return true;
@@ -284,11 +586,11 @@ bool UserDAO::assign_role(const std::shared_ptr<models::User>& user, const std::
 
 bool UserDAO::remove_role(const std::shared_ptr<models::User>& user, const std::shared_ptr<models::UserRole>& role) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
-        txn.exec(
-            "DELETE FROM user_role_assignment WHERE user_id = " + txn.quote(user->id()) +
-            " AND role_id = " + txn.quote(role->id()));
+        txn.exec_prepared("user_remove_role", user->id(), role->id());
 
         txn.commit();
         return true;
@@ -300,16 +602,14 @@ bool UserDAO::remove_role(const std::shared_ptr<models::User>& user, const std::
 
 bool UserDAO::has_role(const std::shared_ptr<models::User>& user, const std::string& role_name) {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT COUNT(*) FROM user_role_assignment ura "
-            "INNER JOIN user_role ur ON ura.role_id = ur.id "
-            "WHERE ura.user_id = " + txn.quote(user->id()) +
-            " AND ur.name = " + txn.quote(role_name));
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_has_role", user->id(), role_name);
 
         txn.commit();
 
-        return result[0][0].as<int>() > 0;
+        return result[0][0].as<bool>();
     } catch (const std::exception& e) {
         std::cerr << "Error in has_role: " << e.what() << std::endl;
         return false;
@@ -318,17 +618,77 @@ bool UserDAO::has_role(const std::shared_ptr<models::User>& user, const std::str
 
 
 
+LoginProfile UserDAO::find_login_profile(const std::string& email) {
+    LoginProfile profile;
+    if (auto cached = users_by_email_.get(email_key(email));
+        cached && !cached->user && cached->email == email) {
+        ++cache_negative_hits_;
+        return profile;
+    }
+
+    try {
+        uint64_t generation = cache_generation_.load();
+        auto conn = pool_->acquire();
+        // Один оператор в режиме автофиксации: без отдельных BEGIN/COMMIT
+        db::Work txn_scope(conn, db::Work::Mode::AUTOCOMMIT);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_login_profile", email);
+
+        if (result.empty()) {
+            cache_missing_email(email, generation);
+            return profile;
+        }
+
+        const auto& row = result[0];
+        profile.user = std::make_shared<models::User>();
+        profile.user->from_row(row);
+        profile.role_names = split_names(row["role_names"]);
+        profile.permission_names = split_names(row["permission_names"]);
+        cache_user(std::make_shared<const models::User>(*profile.user), generation);
+    } catch (const std::exception& e) {
+        std::cerr << "Error in find_login_profile: " << e.what() << std::endl;
+        profile.user = nullptr;
+    }
+    return profile;
+}
+
+bool UserDAO::record_login(const std::shared_ptr<models::User>& user) {
+    try {
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn, db::Work::Mode::AUTOCOMMIT);
+        auto& txn = txn_scope.get();
+        // Проверенный хеш входит в условие: смена пароля после чтения профиля отменяет вход
+        auto result = txn.exec_prepared("user_record_login", user->id(), user->password_hash());
+
+        invalidate(user->id(), user->email());
+        if (result.empty()) {
+            return false;
+        }
+        if (!result[0][0].is_null()) {
+            user->set_last_login_at(result[0][0].as<std::string>());
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in record_login: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 bool UserDAO::update_last_login(const std::shared_ptr<models::User>& user) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
-        txn.exec(
-            "UPDATE app_user SET last_login_at = CURRENT_TIMESTAMP WHERE id = " + txn.quote(user->id()));
+        auto result = txn.exec_prepared("user_update_last_login", user->id());
 
         txn.commit();
 
         // Обновляем объект пользователя
-        user->set_last_login_at("CURRENT_TIMESTAMP");
+        if (!result.empty() && !result[0][0].is_null()) {
+            user->set_last_login_at(result[0][0].as<std::string>());
+        }
+        invalidate(user->id(), user->email());
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in update_last_login: " << e.what() << std::endl;
@@ -338,16 +698,17 @@ bool UserDAO::update_last_login(const std::shared_ptr<models::User>& user) {
 
 bool UserDAO::change_password(const std::shared_ptr<models::User>& user, const std::string& new_password_hash) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
-        txn.exec(
-            "UPDATE app_user SET password_hash = " + txn.quote(new_password_hash) +
-            ", password_change_required = false, updated_at = CURRENT_TIMESTAMP WHERE id = " + txn.quote(user->id()));
+        txn.exec_prepared("user_change_password", user->id(), new_password_hash);
 
         txn.commit();
 
         // Обновляем объект пользователя
         user->set_password_hash(new_password_hash);
+        invalidate(user->id(), user->email());
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in change_password: " << e.what() << std::endl;
@@ -357,15 +718,17 @@ bool UserDAO::change_password(const std::shared_ptr<models::User>& user, const s
 
 bool UserDAO::deactivate_user(const std::shared_ptr<models::User>& user) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
-        txn.exec(
-            "UPDATE app_user SET is_active = false, updated_at = CURRENT_TIMESTAMP WHERE id = " + txn.quote(user->id()));
+        txn.exec_prepared("user_set_active", user->id(), false);
 
         txn.commit();
 
         // Обновляем объект пользователя
         user->set_active(false);
+        invalidate(user->id(), user->email());
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in deactivate_user: " << e.what() << std::endl;
@@ -375,15 +738,17 @@ bool UserDAO::deactivate_user(const std::shared_ptr<models::User>& user) {
 
 bool UserDAO::activate_user(const std::shared_ptr<models::User>& user) {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
 
-        txn.exec(
-            "UPDATE app_user SET is_active = true, updated_at = CURRENT_TIMESTAMP WHERE id = " + txn.quote(user->id()));
+        txn.exec_prepared("user_set_active", user->id(), true);
 
         txn.commit();
 
         // Обновляем объект пользователя
         user->set_active(true);
+        invalidate(user->id(), user->email());
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error in activate_user: " << e.what() << std::endl;
@@ -395,22 +760,16 @@ std::vector<std::shared_ptr<models::User>> UserDAO::find_by_name(const std::stri
     std::vector<std::shared_ptr<models::User>> users;
 
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, first_name, last_name, patronymic, email, phone, "
-            "password_hash, is_active, password_change_required, created_at, "
-            "updated_at, last_login_at FROM app_user "
-            "WHERE first_name ILIKE " + txn.quote(first_name + "%") +
-            " AND last_name ILIKE " + txn.quote(last_name + "%") +
-            " ORDER BY first_name, last_name");
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("user_find_by_name",
+            txn.esc_like(first_name) + "%",
+            txn.esc_like(last_name) + "%");
 
         txn.commit();
 
-        for (const auto& row : result) {
-            auto user = std::make_shared<models::User>();
-            user->from_row(row);
-            users.push_back(user);
-        }
+        users = users_from_result(result);
     } catch (const std::exception& e) {
         std::cerr << "Error in find_by_name: " << e.what() << std::endl;
     }
@@ -420,11 +779,10 @@ std::vector<std::shared_ptr<models::User>> UserDAO::find_by_name(const std::stri
 
 std::shared_ptr<models::UserRole> UserDAO::get_role_by_name(const std::string& role_name) {
     try {
-        pqxx::work txn(*connection_);
-        auto result = txn.exec(
-            "SELECT id, name, description, is_system, created_at, updated_at "
-            "FROM user_role WHERE name = " + txn.quote(role_name)
-        );
+        auto conn = pool_->acquire();
+        db::Work txn_scope(conn);
+        auto& txn = txn_scope.get();
+        auto result = txn.exec_prepared("role_find_by_name", role_name);
 
         txn.commit();
 
@@ -442,4 +800,4 @@ std::shared_ptr<models::UserRole> UserDAO::get_role_by_name(const std::string& r
     }
 }
 
-} // namespace dao
\ No newline at end of file
+} // namespace dao
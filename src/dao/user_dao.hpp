@@ -1,31 +1,91 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <string>
 #include <pqxx/pqxx>
+#include "../db/connection_pool.hpp"
 #include "../models/user.hpp"
+#include "../models/user_batch.hpp"
 #include "../models/user_role.hpp"
 #include "../models/user_role_assignment.hpp"
+#include "../utils/sharded_lru_cache.hpp"
 
 namespace dao {
 
+struct UserCacheConfig {
+    // 0 - кэш выключен
+    size_t capacity = 4096;
+    size_t shards = 16;
+    // Ограничивает устаревание при изменениях в обход UserDAO (другой экземпляр, импорт)
+    std::chrono::seconds ttl{60};
+    // Короткий срок для несуществующих email: гасит перебор адресов
+    std::chrono::seconds negative_ttl{5};
+};
+
+struct UserCacheStats {
+    uint64_t hits = 0;
+    uint64_t negative_hits = 0;
+    uint64_t misses = 0;
+    size_t entries = 0;
+};
+
+// Всё, что нужно для входа, одним запросом
+struct LoginProfile {
+    // nullptr, если пользователь не найден или запрос не удался
+    std::shared_ptr<models::User> user;
+    std::vector<std::string> role_names;
+    std::vector<std::string> permission_names;
+};
+
 class UserDAO {
 private:
-    std::shared_ptr<pqxx::connection> connection_;
+    // Запись по email; user == nullptr - email точно не найден в базе
+    struct CachedEmail {
+        std::shared_ptr<const models::User> user;
+        std::string email;
+    };
+
+    std::shared_ptr<db::ConnectionPool> pool_;
+
+    UserCacheConfig cache_config_;
+    utils::ShardedLruCache<std::string, std::shared_ptr<const models::User>> users_by_id_;
+    utils::ShardedLruCache<std::string, CachedEmail> users_by_email_;
+    // Меняется при каждой инвалидации: результат чтения, начатого до записи, не кэшируется
+    std::atomic<uint64_t> cache_generation_{0};
+    std::atomic<uint64_t> cache_hits_{0};
+    std::atomic<uint64_t> cache_negative_hits_{0};
+    std::atomic<uint64_t> cache_misses_{0};
 
 public:
-    explicit UserDAO(std::shared_ptr<pqxx::connection> conn);
+    explicit UserDAO(std::shared_ptr<db::ConnectionPool> pool, UserCacheConfig cache_config = {});
 
     // CRUD операции
     std::shared_ptr<models::User> find_by_id(const std::string& id);
     std::shared_ptr<models::User> find_by_email(const std::string& email);
     std::shared_ptr<models::User> find_by_credentials(const std::string& email, const std::string& password_hash);
     std::vector<std::shared_ptr<models::User>> find_all();
+    // То же без хэшей паролей, строки всех пользователей в одной арене
+    models::UserBatch find_all_batch();
+    // Обход пользователей серверным курсором порциями по batch_size: память не растёт с
+    // числом пользователей. callback возвращает false, чтобы остановить обход.
+    // Возвращает false при ошибке БД.
+    bool for_each_user(const std::function<bool(const models::UserView&)>& callback,
+                       bool active_only = false, size_t batch_size = 1000);
     std::vector<std::shared_ptr<models::User>> find_active_users();
     bool save(const std::shared_ptr<models::User>& user);
     bool update(const std::shared_ptr<models::User>& user);
     bool remove(const std::shared_ptr<models::User>& user);
     bool delete_by_id(const std::string& id);
+    // Вставляет пользователей и их роли одной транзакцией через COPY. role_ids[i] -
+    // идентификаторы ролей users[i]. Возвращает для каждого пользователя, вставлен ли
+    // он (false - email уже занят); nullopt при ошибке БД, тогда не вставлено ничего.
+    std::optional<std::vector<bool>> save_bulk(const std::vector<std::shared_ptr<models::User>>& users,
+                                               const std::vector<std::vector<std::string>>& role_ids);
 
     // Управление ролями
     std::vector<std::shared_ptr<models::UserRole>> user_roles(const std::shared_ptr<models::User>& user);
@@ -33,6 +93,13 @@ public:
     bool remove_role(const std::shared_ptr<models::User>& user, const std::shared_ptr<models::UserRole>& role);
     bool has_role(const std::shared_ptr<models::User>& user, const std::string& role_name);
 
+    // Вход: пользователь, его роли и разрешения за один запрос. Читает базу
+    // в обход кэша (нужен актуальный хеш), но учитывает отрицательные записи.
+    LoginProfile find_login_profile(const std::string& email);
+    // Отмечает успешный вход. false, если хеш пароля сменился или учётная запись
+    // отключена после чтения профиля.
+    bool record_login(const std::shared_ptr<models::User>& user);
+
     // Бизнес-методы
     bool update_last_login(const std::shared_ptr<models::User>& user);
     bool change_password(const std::shared_ptr<models::User>& user, const std::string& new_password_hash);
@@ -44,7 +111,17 @@ public:
     std::vector<std::shared_ptr<models::User>> find_users_requiring_password_change();
     std::shared_ptr<models::UserRole> get_role_by_name(const std::string& role_name);
 
+    // Кэш пользователей по id и email (без учёта регистра). find_by_id и find_by_email
+    // возвращают копии, изменения через методы UserDAO сбрасывают записи.
+    UserCacheStats cache_stats() const;
+    void clear_cache();
+
 private:
+    void cache_user(const std::shared_ptr<const models::User>& user, uint64_t generation);
+    void cache_missing_email(const std::string& email, uint64_t generation);
+    void invalidate(const std::string& id, const std::string& email);
+    static std::string email_key(const std::string& email);
+
     std::shared_ptr<models::User> user_from_row(const pqxx::row& row);
     std::shared_ptr<models::UserRole> role_from_row(const pqxx::row& row);
 };
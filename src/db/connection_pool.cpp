@@ -0,0 +1,296 @@
+#include "connection_pool.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include "transaction_scope.hpp"
+
+namespace db {
+
+PooledConnection::PooledConnection(ConnectionPool* pool, std::unique_ptr<pqxx::connection> conn,
+                                   uint64_t generation)
+    : pool_(pool), connection_(std::move(conn)), generation_(generation) {}
+
+PooledConnection::PooledConnection(pqxx::connection& borrowed)
+    : pool_(nullptr), generation_(0), borrowed_(&borrowed) {}
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : pool_(other.pool_), connection_(std::move(other.connection_)), generation_(other.generation_),
+      borrowed_(other.borrowed_) {
+    other.pool_ = nullptr;
+    other.borrowed_ = nullptr;
+}
+
+PooledConnection& PooledConnection::operator=(PooledConnection&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        connection_ = std::move(other.connection_);
+        generation_ = other.generation_;
+        borrowed_ = other.borrowed_;
+        other.pool_ = nullptr;
+        other.borrowed_ = nullptr;
+    }
+    return *this;
+}
+
+PooledConnection::~PooledConnection() {
+    release();
+}
+
+void PooledConnection::release() {
+    if (pool_ && connection_) {
+        pool_->release(std::move(connection_), generation_);
+    }
+    pool_ = nullptr;
+}
+
+ConnectionPool::ConnectionPool(std::string connection_string, PoolConfig config, ConnectHook on_connect)
+    : connection_string_(std::move(connection_string)),
+      config_(config),
+      on_connect_(std::move(on_connect)) {
+    if (config_.max_size == 0) {
+        throw std::invalid_argument("Connection pool max_size must be positive");
+    }
+    config_.min_size = std::min(config_.min_size, config_.max_size);
+
+    // Прогреваем пул до минимального размера
+    for (size_t i = 0; i < config_.min_size; ++i) {
+        uint64_t generation = 0;
+        auto conn = open_connection(generation);
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back({std::move(conn), clock::now(), generation});
+        ++total_;
+        ++counters_.connections_created;
+    }
+}
+
+ConnectionPool::~ConnectionPool() {
+    close();
+}
+
+std::unique_ptr<pqxx::connection> ConnectionPool::open_connection(uint64_t& generation) {
+    auto conn = std::make_unique<pqxx::connection>(connection_string_);
+    if (!conn->is_open()) {
+        throw std::runtime_error("Failed to open database connection");
+    }
+    run_on_connect(*conn, generation);
+    return conn;
+}
+
+void ConnectionPool::run_on_connect(pqxx::connection& conn, uint64_t& generation) {
+    ConnectHook hook;
+    uint64_t current = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hook = on_connect_;
+        current = generation_;
+    }
+    if (hook) {
+        hook(conn);
+    }
+    generation = current;
+}
+
+void ConnectionPool::set_on_connect(ConnectHook on_connect) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    on_connect_ = std::move(on_connect);
+    ++generation_;
+}
+
+bool ConnectionPool::is_healthy(pqxx::connection& conn, clock::time_point idle_since) const {
+    if (!conn.is_open()) {
+        return false;
+    }
+    if (clock::now() - idle_since < config_.health_check_after) {
+        return true;
+    }
+    try {
+        pqxx::nontransaction ping(conn);
+        ping.exec("SELECT 1");
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Pooled connection failed health check: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+PooledConnection ConnectionPool::acquire() {
+    if (auto* batch = BatchTransaction::active(this)) {
+        return PooledConnection(*batch->connection_);
+    }
+    return acquire_outside_batch();
+}
+
+PooledConnection ConnectionPool::acquire_outside_batch() {
+    const auto started = clock::now();
+    const auto deadline = started + config_.checkout_timeout;
+    bool waited = false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (closed_) {
+            throw std::runtime_error("Connection pool is closed");
+        }
+
+        if (!idle_.empty()) {
+            IdleConnection entry = std::move(idle_.back());
+            idle_.pop_back();
+            const bool stale = entry.generation != generation_;
+            ++in_use_;
+            lock.unlock();
+
+            if (is_healthy(*entry.connection, entry.idle_since)) {
+                if (stale) {
+                    try {
+                        run_on_connect(*entry.connection, entry.generation);
+                    } catch (...) {
+                        entry.connection.reset();
+                        discard_slot();
+                        throw;
+                    }
+                }
+                record_checkout(started, waited);
+                return PooledConnection(this, std::move(entry.connection), entry.generation);
+            }
+
+            entry.connection.reset();
+            lock.lock();
+            --in_use_;
+            --total_;
+            ++counters_.health_check_failures;
+            continue;
+        }
+
+        if (total_ < config_.max_size) {
+            ++total_;
+            ++in_use_;
+            lock.unlock();
+
+            std::unique_ptr<pqxx::connection> conn;
+            uint64_t generation = 0;
+            try {
+                conn = open_connection(generation);
+            } catch (...) {
+                discard_slot();
+                throw;
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                ++counters_.connections_created;
+            }
+            record_checkout(started, waited);
+            return PooledConnection(this, std::move(conn), generation);
+        }
+
+        waited = true;
+        ++waiting_;
+        bool ready = available_.wait_until(lock, deadline, [this] {
+            return closed_ || !idle_.empty() || total_ < config_.max_size;
+        });
+        --waiting_;
+
+        if (!ready) {
+            ++counters_.timeouts;
+            throw std::runtime_error("Timed out waiting for a database connection");
+        }
+    }
+}
+
+void ConnectionPool::record_checkout(clock::time_point started, bool waited) {
+    auto wait_time = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - started);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++counters_.checkouts;
+    counters_.peak_in_use = std::max(counters_.peak_in_use, in_use_);
+    if (waited) {
+        ++counters_.waited_checkouts;
+    }
+    counters_.total_wait_time += wait_time;
+    counters_.max_wait_time = std::max(counters_.max_wait_time, wait_time);
+}
+
+void ConnectionPool::discard_slot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_use_;
+    --total_;
+    available_.notify_one();
+}
+
+void ConnectionPool::release(std::unique_ptr<pqxx::connection> conn, uint64_t generation) {
+    // Объявлены до блокировки, чтобы закрывать соединения уже после её снятия
+    std::vector<std::unique_ptr<pqxx::connection>> reaped;
+    std::unique_ptr<pqxx::connection> broken;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_use_;
+
+    if (closed_ || !conn || !conn->is_open()) {
+        broken = std::move(conn);
+        --total_;
+    } else {
+        idle_.push_back({std::move(conn), clock::now(), generation});
+        reap_idle_locked(clock::now(), reaped);
+    }
+
+    available_.notify_one();
+}
+
+size_t ConnectionPool::reap_idle_locked(clock::time_point now,
+                                        std::vector<std::unique_ptr<pqxx::connection>>& reaped) {
+    size_t count = 0;
+    while (!idle_.empty() && total_ > config_.min_size &&
+           now - idle_.front().idle_since >= config_.idle_timeout) {
+        reaped.push_back(std::move(idle_.front().connection));
+        idle_.pop_front();
+        --total_;
+        ++counters_.connections_reaped;
+        ++count;
+    }
+    return count;
+}
+
+size_t ConnectionPool::reap_idle() {
+    std::vector<std::unique_ptr<pqxx::connection>> reaped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reap_idle_locked(clock::now(), reaped);
+}
+
+PoolStats ConnectionPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PoolStats snapshot = counters_;
+    snapshot.total = total_;
+    snapshot.in_use = in_use_;
+    snapshot.idle = idle_.size();
+    snapshot.waiting = waiting_;
+    return snapshot;
+}
+
+void ConnectionPool::close() {
+    std::deque<IdleConnection> to_close;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        to_close.swap(idle_);
+        total_ -= to_close.size();
+    }
+    available_.notify_all();
+
+    for (auto& entry : to_close) {
+        try {
+            entry.connection->close();
+        } catch (const std::exception& e) {
+            std::cerr << "Error closing pooled connection: " << e.what() << std::endl;
+        }
+    }
+}
+
+bool ConnectionPool::is_closed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+}
+
+} // namespace db
@@ -0,0 +1,136 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+
+namespace db {
+
+struct PoolConfig {
+    size_t min_size = 2;
+    size_t max_size = 8;
+    // Сколько ждать свободное соединение, прежде чем бросить исключение
+    std::chrono::milliseconds checkout_timeout{5000};
+    // Простаивающие соединения сверх min_size закрываются после этого срока
+    std::chrono::seconds idle_timeout{300};
+    // Соединение, простоявшее дольше этого срока, проверяется через SELECT 1 при выдаче
+    std::chrono::seconds health_check_after{30};
+};
+
+struct PoolStats {
+    size_t total = 0;
+    size_t in_use = 0;
+    size_t idle = 0;
+    size_t waiting = 0;
+    size_t peak_in_use = 0;
+
+    uint64_t checkouts = 0;
+    uint64_t waited_checkouts = 0;
+    uint64_t timeouts = 0;
+    uint64_t connections_created = 0;
+    uint64_t connections_reaped = 0;
+    uint64_t health_check_failures = 0;
+
+    std::chrono::microseconds total_wait_time{0};
+    std::chrono::microseconds max_wait_time{0};
+};
+
+class ConnectionPool;
+
+// Соединение, взятое из пула. Возвращается в пул в деструкторе.
+// Заимствованное (соединение BatchTransaction) в пул не возвращается.
+class PooledConnection {
+public:
+    PooledConnection(ConnectionPool* pool, std::unique_ptr<pqxx::connection> conn, uint64_t generation);
+    explicit PooledConnection(pqxx::connection& borrowed);
+    PooledConnection(PooledConnection&& other) noexcept;
+    PooledConnection& operator=(PooledConnection&& other) noexcept;
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+    ~PooledConnection();
+
+    pqxx::connection& operator*() const { return *get(); }
+    pqxx::connection* operator->() const { return get(); }
+    pqxx::connection* get() const { return connection_ ? connection_.get() : borrowed_; }
+
+private:
+    ConnectionPool* pool_;
+    std::unique_ptr<pqxx::connection> connection_;
+    uint64_t generation_;
+    pqxx::connection* borrowed_ = nullptr;
+
+    void release();
+};
+
+class ConnectionPool {
+public:
+    using ConnectHook = std::function<void(pqxx::connection&)>;
+    using clock = std::chrono::steady_clock;
+
+    ConnectionPool(std::string connection_string,
+                   PoolConfig config = {},
+                   ConnectHook on_connect = nullptr);
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Внутри BatchTransaction этого пула на текущем потоке возвращает её соединение
+    PooledConnection acquire();
+    // Всегда отдельное соединение пула, даже внутри BatchTransaction: для коротких
+    // транзакций, которые не должны ждать фиксации пакета
+    PooledConnection acquire_outside_batch();
+
+    // Заменяет хук инициализации соединения. Уже открытые соединения
+    // прогоняются через новый хук при следующей выдаче из пула.
+    void set_on_connect(ConnectHook on_connect);
+
+    PoolStats stats() const;
+    size_t reap_idle();
+    void close();
+
+    bool is_closed() const;
+    const PoolConfig& config() const { return config_; }
+    const std::string& connection_string() const { return connection_string_; }
+
+private:
+    friend class PooledConnection;
+
+    struct IdleConnection {
+        std::unique_ptr<pqxx::connection> connection;
+        clock::time_point idle_since;
+        uint64_t generation;
+    };
+
+    std::string connection_string_;
+    PoolConfig config_;
+    ConnectHook on_connect_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    // Свободные соединения: в конце самые "тёплые", в начале самые старые
+    std::deque<IdleConnection> idle_;
+    size_t total_ = 0;
+    size_t in_use_ = 0;
+    size_t waiting_ = 0;
+    bool closed_ = false;
+    uint64_t generation_ = 0;
+    PoolStats counters_;
+
+    std::unique_ptr<pqxx::connection> open_connection(uint64_t& generation);
+    void run_on_connect(pqxx::connection& conn, uint64_t& generation);
+    bool is_healthy(pqxx::connection& conn, clock::time_point idle_since) const;
+    void release(std::unique_ptr<pqxx::connection> conn, uint64_t generation);
+    void discard_slot();
+    void record_checkout(clock::time_point started, bool waited);
+    size_t reap_idle_locked(clock::time_point now,
+                            std::vector<std::unique_ptr<pqxx::connection>>& reaped);
+};
+
+} // namespace db
@@ -8,6 +8,9 @@
 #include <fstream>
 #include <functional>
 #include <filesystem>
+#include "migrations.hpp"
+#include "statement_catalog.hpp"
+#include "uuid_columns.hpp"
 #include "../dao/log_dao.hpp"
 #include "../dao/user_dao.hpp"
 #include "../dao/access_permission_dao.hpp"
@@ -21,18 +24,15 @@ Database::Database(
     unsigned int port,
     const std::string& database,
     const std::string& user,
-    const std::string& password
+    const std::string& password,
+    const PoolConfig& pool_config
 ) {
     try {
         connection_string_ = "postgresql://" + user + ":" + password + "@" + host + 
                            ":" + std::to_string(port) + "/" + database;
         
-        // Создаем соединение с базой данных
-        connection_ = std::make_shared<pqxx::connection>(connection_string_);
-        
-        if (!connection_->is_open()) {
-            throw std::runtime_error("Failed to open database connection");
-        }
+        // Создаем пул соединений с базой данных
+        pool_ = std::make_shared<ConnectionPool>(connection_string_, pool_config);
         
         std::cout << "Connected to PostgreSQL database: " << database 
                   << " on " << host << ":" << port << std::endl;
@@ -47,18 +47,20 @@ std::shared_ptr<Database> Database::create(
     unsigned int port,
     const std::string& database,
     const std::string& user,
-    const std::string& password) {
+    const std::string& password,
+    const PoolConfig& pool_config) {
     
-    return std::make_shared<Database>(host, port, database, user, password);
+    return std::make_shared<Database>(host, port, database, user, password, pool_config);
 }
 
 bool Database::test_connection() {
     try {
-        if (!connection_ || !connection_->is_open()) {
+        if (!is_connected()) {
             return false;
         }
         
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        pqxx::work txn(*conn);
         auto result = txn.exec("SELECT 1 as test_value");
         txn.commit();
         
@@ -73,120 +75,69 @@ bool Database::test_connection() {
 }
 
 void Database::close() {
-    if (connection_ && connection_->is_open()) {
-        connection_->close();
-        std::cout << "Database connection closed" << std::endl;
+    if (pool_ && !pool_->is_closed()) {
+        pool_->close();
+        std::cout << "Database connection pool closed" << std::endl;
     }
-    connection_.reset();
+    pool_.reset();
 }
 
-bool Database::create_schema() {
-    try {
-        pqxx::work txn(*connection_);
-        
-        // Создаем таблицу пользователей
-        txn.exec(
-            "CREATE TABLE IF NOT EXISTS app_user ("
-            "id VARCHAR(36) PRIMARY KEY,"
-            "first_name VARCHAR(100) NOT NULL,"
-            "last_name VARCHAR(100) NOT NULL,"
-            "patronymic VARCHAR(100),"
-            "email VARCHAR(255) UNIQUE NOT NULL,"
-            "phone VARCHAR(20),"
-            "password_hash VARCHAR(255) NOT NULL,"
-            "is_active BOOLEAN NOT NULL DEFAULT true,"
-            "password_change_required BOOLEAN NOT NULL DEFAULT true,"
-            "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-            "updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-            "last_login_at TIMESTAMP"
-            ")"
-        );
-        
-        // Создаем таблицу ролей
-        txn.exec(
-            "CREATE TABLE IF NOT EXISTS user_role ("
-            "id VARCHAR(36) PRIMARY KEY,"
-            "name VARCHAR(50) UNIQUE NOT NULL,"
-            "description TEXT,"
-            "is_system BOOLEAN NOT NULL DEFAULT false,"
-            "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-            "updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
-            ")"
-        );
-        
-        // Создаем таблицу назначения ролей
-        txn.exec(
-            "CREATE TABLE IF NOT EXISTS user_role_assignment ("
-            "id SERIAL PRIMARY KEY,"
-            "user_id VARCHAR(36) NOT NULL REFERENCES app_user(id) ON DELETE CASCADE,"
-            "role_id VARCHAR(36) NOT NULL REFERENCES user_role(id) ON DELETE CASCADE,"
-            "assigned_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-            "UNIQUE(user_id, role_id)"
-            ")"
-        );
-        
-        // Создаем таблицу разрешений
-        txn.exec(
-            "CREATE TABLE IF NOT EXISTS access_permission ("
-            "id VARCHAR(36) PRIMARY KEY,"
-            "name VARCHAR(50) UNIQUE NOT NULL,"
-            "description TEXT"
-            ")"
-        );
-        
-        // Создаем таблицу связи ролей и разрешений
-        txn.exec(
-            "CREATE TABLE IF NOT EXISTS role_permission ("
-            "id SERIAL PRIMARY KEY,"
-            "role_id VARCHAR(36) NOT NULL REFERENCES user_role(id) ON DELETE CASCADE,"
-            "permission_id VARCHAR(36) NOT NULL REFERENCES access_permission(id) ON DELETE CASCADE,"
-            "granted_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-            "UNIQUE(role_id, permission_id)"
-            ")"
-        );
-        
-        // Создаем таблицу логов
-        txn.exec(
-            "CREATE TABLE IF NOT EXISTS system_log ("
-            "id VARCHAR(36) PRIMARY KEY,"
-            "level VARCHAR(10) NOT NULL,"
-            "action_type VARCHAR(50) NOT NULL,"
-            "message TEXT NOT NULL,"
-            "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
-            "actor_id VARCHAR(36) REFERENCES app_user(id) ON DELETE SET NULL,"
-            "subject_id VARCHAR(36) REFERENCES app_user(id) ON DELETE SET NULL,"
-            "ip_address VARCHAR(45),"
-            "user_agent TEXT"
-            ")"
-        );
-        
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_app_user_email ON app_user(email)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_app_user_active ON app_user(is_active)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_user_role_name ON user_role(name)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_user_role_assignment_user ON user_role_assignment(user_id)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_user_role_assignment_role ON user_role_assignment(role_id)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_system_log_timestamp ON system_log(timestamp)");
-        txn.exec("CREATE INDEX IF NOT EXISTS idx_system_log_level ON system_log(level)");
-        
-        txn.commit();
-        std::cout << "Database schema created successfully" << std::endl;
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to create schema: " << e.what() << std::endl;
+bool Database::migrate(bool native_uuid_ids) {
+    MigrationRunner runner(pool_);
+    auto report = runner.run();
+    if (!report.success) {
+        std::cerr << "Failed to migrate schema from version " << report.version_after << std::endl;
         return false;
     }
+
+    if (report.applied > 0) {
+        std::cout << "Database schema migrated from version " << report.version_before
+                  << " to " << report.version_after << std::endl;
+    } else {
+        std::cout << "Database schema is up to date (version " << report.version_after << ")" << std::endl;
+    }
+
+    // До подготовки запросов: типы параметров выводятся из столбцов при PREPARE
+    if (native_uuid_ids) {
+        try {
+            auto conn = pool_->acquire();
+            pqxx::work txn(*conn);
+            if (convert_ids_to_uuid(txn)) {
+                std::cout << "Converted user and log ids to native uuid columns" << std::endl;
+            }
+            txn.commit();
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to convert ids to uuid: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    prepare_statements();
+    return true;
+}
+
+// Запросы готовятся только после создания схемы: PostgreSQL проверяет таблицы при PREPARE
+void Database::prepare_statements() {
+    pool_->set_on_connect(StatementCatalog::prepare_all);
+    std::cout << "Registered " << StatementCatalog::size() << " prepared statements" << std::endl;
 }
 
 bool Database::drop_schema() {
     try {
-        pqxx::work txn(*connection_);
+        auto conn = pool_->acquire();
+        pqxx::work txn(*conn);
         
         txn.exec("DROP TABLE IF EXISTS role_permission CASCADE");
         txn.exec("DROP TABLE IF EXISTS user_role_assignment CASCADE");
         txn.exec("DROP TABLE IF EXISTS system_log CASCADE");
+        txn.exec("DROP VIEW IF EXISTS system_log_counts");
+        txn.exec("DROP TABLE IF EXISTS system_log_rollup_delta");
+        txn.exec("DROP TABLE IF EXISTS system_log_rollup");
         txn.exec("DROP TABLE IF EXISTS access_permission CASCADE");
         txn.exec("DROP TABLE IF EXISTS user_role CASCADE");
         txn.exec("DROP TABLE IF EXISTS app_user CASCADE");
+        txn.exec("DROP TABLE IF EXISTS revoked_subject");
+        txn.exec("DROP TABLE IF EXISTS schema_version");
         
         txn.commit();
         std::cout << "Database schema dropped successfully" << std::endl;
@@ -197,20 +148,13 @@ bool Database::drop_schema() {
     }
 }
 
-std::unique_ptr<pqxx::work> Database::begin_transaction() {
-    try {
-        return std::make_unique<pqxx::work>(*connection_);
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Failed to begin transaction: " + std::string(e.what()));
-    }
-}
-
 bool Database::backup(const std::string& backup_path) {
     try {
-        std::string host = connection_->hostname();
-        std::string port = connection_->port();
-        std::string dbname = connection_->dbname();
-        std::string user = connection_->username();
+        auto conn = pool_->acquire();
+        std::string host = conn->hostname();
+        std::string port = conn->port();
+        std::string dbname = conn->dbname();
+        std::string user = conn->username();
         
         std::string password = "password"; // Это нужно исправить в реальном приложении
         
@@ -260,10 +204,11 @@ bool Database::restore(const std::string& backup_path) {
             return false;
         }
         
-        std::string host = connection_->hostname();
-        std::string port = connection_->port();
-        std::string dbname = connection_->dbname();
-        std::string user = connection_->username();
+        auto conn = pool_->acquire();
+        std::string host = conn->hostname();
+        std::string port = conn->port();
+        std::string dbname = conn->dbname();
+        std::string user = conn->username();
         std::string password = "password"; // Это нужно исправить в реальном приложении
         
         std::string command = "pg_restore";
@@ -304,47 +249,65 @@ bool Database::restore(const std::string& backup_path) {
 }
 
 std::string Database::get_connection_info() const {
-    if (!connection_) {
+    if (!is_connected()) {
         return "No connection";
     }
     
+    auto conn = pool_->acquire();
+    auto stats = pool_->stats();
+
     std::stringstream info;
-    info << "Host: " << connection_->hostname()
-         << ", Port: " << connection_->port()
-         << ", Database: " << connection_->dbname()
-         << ", User: " << connection_->username()
-         << ", Status: " << (connection_->is_open() ? "Connected" : "Disconnected");
+    info << "Host: " << conn->hostname()
+         << ", Port: " << conn->port()
+         << ", Database: " << conn->dbname()
+         << ", User: " << conn->username()
+         << ", Status: " << (conn->is_open() ? "Connected" : "Disconnected")
+         << ", Pool: " << stats.in_use << "/" << stats.total << " in use";
     
     return info.str();
 }
 
+PoolStats Database::get_pool_stats() const {
+    if (!pool_) {
+        return {};
+    }
+    return pool_->stats();
+}
+
 DAOFactory::DAOFactory(std::shared_ptr<Database> db) : database_(std::move(db)) {}
 
 std::shared_ptr<dao::UserDAO> DAOFactory::create_user_dao() {
-    if (!database_ || !database_->get_connection()) {
+    if (!database_ || !database_->is_connected()) {
         throw std::runtime_error("Database connection is not available");
     }
-    return std::shared_ptr<dao::UserDAO>(new dao::UserDAO(database_->get_connection()));
+    return std::shared_ptr<dao::UserDAO>(new dao::UserDAO(database_->get_pool()));
 }
 
 std::shared_ptr<dao::LogDAO> DAOFactory::create_log_dao() {
-    if (!database_ || !database_->get_connection()) {
+    if (!database_ || !database_->is_connected()) {
         throw std::runtime_error("Database connection is not available");
     }
-    return std::shared_ptr<dao::LogDAO>(new dao::LogDAO(database_->get_connection()));
+    return std::shared_ptr<dao::LogDAO>(new dao::LogDAO(database_->get_pool()));
 }
 
 std::shared_ptr<dao::AccessPermissionDAO> DAOFactory::create_permission_dao() {
-    if (!database_ || !database_->get_connection()) {
+    if (!database_ || !database_->is_connected()) {
         throw std::runtime_error("Database connection is not available");
     }
-    return std::shared_ptr<dao::AccessPermissionDAO>(new dao::AccessPermissionDAO(database_->get_connection()));
+    return std::shared_ptr<dao::AccessPermissionDAO>(new dao::AccessPermissionDAO(database_->get_pool()));
 }
 
 std::shared_ptr<dao::DataExportImportDAO> DAOFactory::create_export_import_dao() {
-    if (!database_ || !database_->get_connection()) {
+    if (!database_ || !database_->is_connected()) {
+        throw std::runtime_error("Database connection is not available");
+    }
+    return std::make_shared<dao::DataExportImportDAO>(database_->get_pool());
+}
+
+std::shared_ptr<dao::RevocationDAO> DAOFactory::create_revocation_dao() {
+    if (!database_ || !database_->is_connected()) {
         throw std::runtime_error("Database connection is not available");
     }
-    return std::make_shared<dao::DataExportImportDAO>(database_->get_connection());
+    return std::make_shared<dao::RevocationDAO>(database_->get_pool());
 }
 }
\ No newline at end of file
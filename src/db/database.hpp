@@ -3,16 +3,18 @@
 #include <memory>
 #include <string>
 #include <pqxx/pqxx>
+#include "connection_pool.hpp"
 #include "src/dao/user_dao.hpp"
 #include "src/dao/log_dao.hpp"
 #include "src/dao/access_permission_dao.hpp"
 #include "src/dao/data_export_import_dao.hpp"
+#include "src/dao/revocation_dao.hpp"
 
 namespace db {
 
 class Database {
 private:
-    std::shared_ptr<pqxx::connection> connection_;
+    std::shared_ptr<ConnectionPool> pool_;
     std::string connection_string_;
 
 public:
@@ -21,7 +23,8 @@ public:
         unsigned int port,
         const std::string& database,
         const std::string& user,
-        const std::string& password
+        const std::string& password,
+        const PoolConfig& pool_config = {}
     );
     
     static std::shared_ptr<Database> create(
@@ -29,22 +32,26 @@ public:
         unsigned int port,
         const std::string& database,
         const std::string& user,
-        const std::string& password);
+        const std::string& password,
+        const PoolConfig& pool_config = {});
     
     bool test_connection();
     void close();
-    bool create_schema();
+    // Приводит схему к последней версии (см. migrations.hpp). native_uuid_ids
+    // переводит идентификаторы пользователей и журнала в тип uuid (см. uuid_columns.hpp)
+    bool migrate(bool native_uuid_ids = false);
+    void prepare_statements();
     bool drop_schema();
-    std::unique_ptr<pqxx::work> begin_transaction();
     bool backup(const std::string& backup_path);
     bool restore(const std::string& backup_path);
     
-    std::shared_ptr<pqxx::connection> get_connection() const { return connection_; }
+    std::shared_ptr<ConnectionPool> get_pool() const { return pool_; }
+    PoolStats get_pool_stats() const;
     const std::string& get_connection_string() const { return connection_string_; }
     std::string get_connection_info() const;
     
     bool is_connected() const { 
-        return connection_ && connection_->is_open(); 
+        return pool_ && !pool_->is_closed(); 
     }
 };
 
@@ -58,6 +65,7 @@ public:
     std::shared_ptr<dao::LogDAO> create_log_dao();
     std::shared_ptr<dao::AccessPermissionDAO> create_permission_dao();
     std::shared_ptr<dao::DataExportImportDAO> create_export_import_dao();
+    std::shared_ptr<dao::RevocationDAO> create_revocation_dao();
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "log_partitions.hpp"
+#include <iostream>
+
+namespace db {
+
+std::vector<std::string> ensure_log_partitions(pqxx::transaction_base& txn, int months_ahead,
+                                               const std::optional<std::string>& since) {
+    std::vector<std::string> created;
+
+    // Месяцы без секции; имена секций строятся только из цифр месяца
+    auto missing = txn.exec_params(
+        "SELECT 'system_log_p' || to_char(m, 'YYYYMM'), m::date::text, (m + interval '1 month')::date::text "
+        "FROM generate_series(date_trunc('month', COALESCE($1::timestamp, CURRENT_TIMESTAMP::timestamp)), "
+        "                     date_trunc('month', CURRENT_TIMESTAMP::timestamp) + make_interval(months => $2), "
+        "                     interval '1 month') AS m "
+        "WHERE to_regclass('system_log_p' || to_char(m, 'YYYYMM')) IS NULL "
+        "ORDER BY m",
+        since, months_ahead);
+
+    // Генерируемые столбцы (message_tsv) при переносе вычисляются заново, поэтому
+    // в INSERT перечисляются только обычные столбцы
+    std::string columns;
+    if (!missing.empty()) {
+        columns = txn.exec1(
+            "SELECT string_agg(quote_ident(column_name), ', ' ORDER BY ordinal_position) "
+            "FROM information_schema.columns "
+            "WHERE table_schema = current_schema() AND table_name = 'system_log' "
+            "AND is_generated = 'NEVER'")[0].as<std::string>();
+    }
+
+    for (const auto& row : missing) {
+        auto name = row[0].as<std::string>();
+        auto from = txn.quote(row[1].as<std::string>());
+        auto to = txn.quote(row[2].as<std::string>());
+
+        // Записи этого месяца могли уже попасть в секцию по умолчанию: PostgreSQL не даст
+        // создать пересекающуюся секцию, поэтому они переносятся в новую таблицу
+        // до ATTACH. Генерируемые столбцы должны остаться генерируемыми, иначе ATTACH отказывает
+        txn.exec("CREATE TABLE " + name +
+                 " (LIKE system_log INCLUDING DEFAULTS INCLUDING CONSTRAINTS INCLUDING GENERATED)");
+        txn.exec(
+            "WITH moved AS (DELETE FROM system_log_default "
+            "WHERE timestamp >= " + from + " AND timestamp < " + to + " RETURNING " + columns + ") "
+            "INSERT INTO " + name + " (" + columns + ") SELECT " + columns + " FROM moved");
+        txn.exec("ALTER TABLE system_log ATTACH PARTITION " + name +
+                 " FOR VALUES FROM (" + from + ") TO (" + to + ")");
+        created.push_back(name);
+    }
+    return created;
+}
+
+std::vector<std::string> drop_log_partitions_before(pqxx::transaction_base& txn,
+                                                    const std::string& before) {
+    std::vector<std::string> dropped;
+
+    // Верхняя граница секции system_log_pYYYYMM - первое число следующего месяца
+    auto expired = txn.exec_params(
+        "SELECT c.relname FROM pg_inherits i JOIN pg_class c ON c.oid = i.inhrelid "
+        "WHERE i.inhparent = 'system_log'::regclass "
+        "AND c.relname ~ '^system_log_p[0-9]{6}$' "
+        "AND to_date(substr(c.relname, 13), 'YYYYMM') + interval '1 month' <= $1::timestamp "
+        "ORDER BY c.relname",
+        before);
+
+    for (const auto& row : expired) {
+        auto name = row[0].as<std::string>();
+        txn.exec("ALTER TABLE system_log DETACH PARTITION " + name);
+        txn.exec("DROP TABLE " + name);
+        dropped.push_back(name);
+    }
+    return dropped;
+}
+
+} // namespace db
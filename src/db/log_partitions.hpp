@@ -0,0 +1,26 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+
+namespace db {
+
+// system_log секционирована по месяцам: system_log_pYYYYMM хранит записи
+// с 1-го числа месяца (включительно) до 1-го числа следующего. Записи вне
+// созданных секций попадают в system_log_default.
+constexpr int LOG_PARTITIONS_AHEAD = 3;
+
+// Создаёт недостающие секции от месяца since (по умолчанию текущего) до
+// текущего месяца плюс months_ahead. Если все секции есть, это один SELECT.
+// Возвращает имена созданных секций.
+std::vector<std::string> ensure_log_partitions(pqxx::transaction_base& txn,
+                                               int months_ahead = LOG_PARTITIONS_AHEAD,
+                                               const std::optional<std::string>& since = std::nullopt);
+
+// Отсоединяет и удаляет секции, все записи которых старше before.
+// Возвращает имена удалённых секций.
+std::vector<std::string> drop_log_partitions_before(pqxx::transaction_base& txn,
+                                                    const std::string& before);
+
+} // namespace db
@@ -0,0 +1,410 @@
+#include "migrations.hpp"
+#include <iostream>
+#include <optional>
+#include <utility>
+#include "log_partitions.hpp"
+#include "src/utils/uuid_generator.hpp"
+
+namespace db {
+
+namespace {
+// Ключ advisory-блокировки, общий для всех экземпляров приложения
+const char* LOCK_KEY_SQL = "hashtext('app_schema_migrations')";
+
+// Схема, которую раньше создавал Database::create_schema. IF NOT EXISTS оставлен,
+// чтобы базы, созданные до появления schema_version, приняли версию 1 без ошибок.
+void create_initial_schema(pqxx::work& txn) {
+    txn.exec(
+        "CREATE TABLE IF NOT EXISTS app_user ("
+        "id VARCHAR(36) PRIMARY KEY,"
+        "first_name VARCHAR(100) NOT NULL,"
+        "last_name VARCHAR(100) NOT NULL,"
+        "patronymic VARCHAR(100),"
+        "email VARCHAR(255) UNIQUE NOT NULL,"
+        "phone VARCHAR(20),"
+        "password_hash VARCHAR(255) NOT NULL,"
+        "is_active BOOLEAN NOT NULL DEFAULT true,"
+        "password_change_required BOOLEAN NOT NULL DEFAULT true,"
+        "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+        "updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+        "last_login_at TIMESTAMP"
+        ")"
+    );
+
+    txn.exec(
+        "CREATE TABLE IF NOT EXISTS user_role ("
+        "id VARCHAR(36) PRIMARY KEY,"
+        "name VARCHAR(50) UNIQUE NOT NULL,"
+        "description TEXT,"
+        "is_system BOOLEAN NOT NULL DEFAULT false,"
+        "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+        "updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+        ")"
+    );
+
+    txn.exec(
+        "CREATE TABLE IF NOT EXISTS user_role_assignment ("
+        "id SERIAL PRIMARY KEY,"
+        "user_id VARCHAR(36) NOT NULL REFERENCES app_user(id) ON DELETE CASCADE,"
+        "role_id VARCHAR(36) NOT NULL REFERENCES user_role(id) ON DELETE CASCADE,"
+        "assigned_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+        "UNIQUE(user_id, role_id)"
+        ")"
+    );
+
+    txn.exec(
+        "CREATE TABLE IF NOT EXISTS access_permission ("
+        "id VARCHAR(36) PRIMARY KEY,"
+        "name VARCHAR(50) UNIQUE NOT NULL,"
+        "description TEXT"
+        ")"
+    );
+
+    txn.exec(
+        "CREATE TABLE IF NOT EXISTS role_permission ("
+        "id SERIAL PRIMARY KEY,"
+        "role_id VARCHAR(36) NOT NULL REFERENCES user_role(id) ON DELETE CASCADE,"
+        "permission_id VARCHAR(36) NOT NULL REFERENCES access_permission(id) ON DELETE CASCADE,"
+        "granted_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+        "UNIQUE(role_id, permission_id)"
+        ")"
+    );
+
+    txn.exec(
+        "CREATE TABLE IF NOT EXISTS system_log ("
+        "id VARCHAR(36) PRIMARY KEY,"
+        "level VARCHAR(10) NOT NULL,"
+        "action_type VARCHAR(50) NOT NULL,"
+        "message TEXT NOT NULL,"
+        "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
+        "actor_id VARCHAR(36) REFERENCES app_user(id) ON DELETE SET NULL,"
+        "subject_id VARCHAR(36) REFERENCES app_user(id) ON DELETE SET NULL,"
+        "ip_address VARCHAR(45),"
+        "user_agent TEXT"
+        ")"
+    );
+
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_app_user_email ON app_user(email)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_app_user_active ON app_user(is_active)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_user_role_name ON user_role(name)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_user_role_assignment_user ON user_role_assignment(user_id)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_user_role_assignment_role ON user_role_assignment(role_id)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_system_log_timestamp ON system_log(timestamp)");
+    // Ключ постраничной выборки журнала (LogDAO::find_by_filter)
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_system_log_timestamp_id ON system_log(timestamp, id)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_system_log_level ON system_log(level)");
+}
+
+// Системные разрешения и роли ADMIN/USER (раньше - initialize_system_permissions при каждом запуске)
+void seed_system_permissions(pqxx::work& txn) {
+    const std::vector<std::pair<std::string, std::string>> system_permissions = {
+        {"USER_CREATE", "Create new users"},
+        {"USER_READ", "View users"},
+        {"USER_UPDATE", "Update users"},
+        {"USER_DELETE", "Delete users"},
+        {"USER_CHANGE_ROLE", "Change user roles"},
+
+        {"ROLE_CREATE", "Create roles"},
+        {"ROLE_READ", "View roles"},
+        {"ROLE_UPDATE", "Update roles"},
+        {"ROLE_DELETE", "Delete roles"},
+
+        {"LOG_READ", "View system logs"},
+        {"LOG_EXPORT", "Export logs"},
+        {"LOG_DELETE", "Delete logs"},
+
+        {"SYSTEM_BACKUP", "Create system backups"},
+        {"SYSTEM_RESTORE", "Restore system from backup"},
+        {"SYSTEM_EXPORT", "Export system data"},
+        {"SYSTEM_IMPORT", "Import system data"}
+    };
+
+    for (const auto& [name, description] : system_permissions) {
+        txn.exec_params(
+            "INSERT INTO access_permission (id, name, description) "
+            "VALUES ($1, $2, $3) "
+            "ON CONFLICT (name) DO NOTHING",
+            utils::UUIDGenerator::generate_uuid(), name, description
+        );
+    }
+
+    txn.exec(
+        "INSERT INTO user_role (id, name, description, is_system) VALUES "
+        "('role-admin', 'ADMIN', 'System Administrator', true), "
+        "('role-user', 'USER', 'Regular User', true) "
+        "ON CONFLICT (id) DO NOTHING"
+    );
+
+    // ADMIN получает все системные разрешения, USER - только просмотр
+    txn.exec(
+        "INSERT INTO role_permission (role_id, permission_id) "
+        "SELECT 'role-admin', id FROM access_permission "
+        "ON CONFLICT (role_id, permission_id) DO NOTHING"
+    );
+    txn.exec(
+        "INSERT INTO role_permission (role_id, permission_id) "
+        "SELECT 'role-user', id FROM access_permission "
+        "WHERE name IN ('USER_READ', 'ROLE_READ', 'LOG_READ') "
+        "ON CONFLICT (role_id, permission_id) DO NOTHING"
+    );
+}
+
+// system_log становится секционированной по месяцам (см. log_partitions.hpp).
+// Существующие записи переносятся в секции, старая таблица удаляется.
+void partition_system_log(pqxx::work& txn) {
+    auto kind = txn.exec1("SELECT relkind::text FROM pg_class WHERE oid = 'system_log'::regclass");
+    if (kind[0].as<std::string>() == "p") {
+        return;
+    }
+
+    // Индекс первичного ключа переименовывается, чтобы имя освободилось для новой таблицы
+    txn.exec("ALTER TABLE system_log RENAME TO system_log_legacy");
+    txn.exec("ALTER INDEX IF EXISTS system_log_pkey RENAME TO system_log_legacy_pkey");
+
+    // Ключ секционирования обязан входить в первичный ключ
+    txn.exec(
+        "CREATE TABLE system_log ("
+        "id VARCHAR(36) NOT NULL,"
+        "level VARCHAR(10) NOT NULL,"
+        "action_type VARCHAR(50) NOT NULL,"
+        "message TEXT NOT NULL,"
+        "timestamp TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,"
+        "actor_id VARCHAR(36) REFERENCES app_user(id) ON DELETE SET NULL,"
+        "subject_id VARCHAR(36) REFERENCES app_user(id) ON DELETE SET NULL,"
+        "ip_address VARCHAR(45),"
+        "user_agent TEXT,"
+        "PRIMARY KEY (id, timestamp)"
+        ") PARTITION BY RANGE (timestamp)"
+    );
+    txn.exec("CREATE TABLE system_log_default PARTITION OF system_log DEFAULT");
+
+    auto oldest = txn.exec1("SELECT MIN(timestamp)::text FROM system_log_legacy");
+    std::optional<std::string> since;
+    if (!oldest[0].is_null()) {
+        since = oldest[0].as<std::string>();
+    }
+    ensure_log_partitions(txn, LOG_PARTITIONS_AHEAD, since);
+
+    txn.exec(
+        "INSERT INTO system_log (id, level, action_type, message, timestamp, "
+        "actor_id, subject_id, ip_address, user_agent) "
+        "SELECT id, level, action_type, message, COALESCE(timestamp, CURRENT_TIMESTAMP), "
+        "actor_id, subject_id, ip_address, user_agent FROM system_log_legacy"
+    );
+    txn.exec("DROP TABLE system_log_legacy");
+
+    // Индексы на родительской таблице создаются и на всех секциях
+    txn.exec("CREATE INDEX idx_system_log_timestamp_id ON system_log(timestamp, id)");
+    txn.exec("CREATE INDEX idx_system_log_level ON system_log(level)");
+}
+
+// Отозванные субъекты токенов сессии (см. services::RevocationList). Строка на
+// субъекта: повторный отзыв берёт новый seq, по которому процессы дочитывают изменения.
+// Внешнего ключа на app_user нет - удалённый пользователь должен остаться отозванным.
+void create_revoked_subject(pqxx::work& txn) {
+    txn.exec("CREATE SEQUENCE revoked_subject_seq");
+    txn.exec(
+        "CREATE TABLE revoked_subject ("
+        "subject_id VARCHAR(36) PRIMARY KEY,"
+        "seq BIGINT NOT NULL DEFAULT nextval('revoked_subject_seq'),"
+        "revoked_at TIMESTAMPTZ NOT NULL DEFAULT now(),"
+        "reason VARCHAR(100)"
+        ")"
+    );
+    txn.exec("ALTER SEQUENCE revoked_subject_seq OWNED BY revoked_subject.seq");
+    txn.exec("CREATE INDEX idx_revoked_subject_seq ON revoked_subject(seq)");
+}
+
+// Почасовые счётчики журнала по уровню и типу действия (см. LogDAO). Их ведёт
+// LogDAO при вставке и удалении; старые часы сворачиваются в сутки. Существующие
+// записи учитываются один раз здесь.
+void create_log_rollup(pqxx::work& txn) {
+    txn.exec(
+        "CREATE TABLE system_log_rollup ("
+        "bucket TIMESTAMP NOT NULL,"
+        "granularity VARCHAR(4) NOT NULL CHECK (granularity IN ('hour', 'day')),"
+        "level VARCHAR(10) NOT NULL,"
+        "action_type VARCHAR(50) NOT NULL,"
+        "count BIGINT NOT NULL,"
+        "PRIMARY KEY (bucket, granularity, level, action_type)"
+        ")"
+    );
+    txn.exec(
+        "INSERT INTO system_log_rollup (bucket, granularity, level, action_type, count) "
+        "SELECT date_trunc('hour', timestamp), 'hour', level, action_type, COUNT(*) "
+        "FROM system_log GROUP BY 1, 3, 4"
+    );
+}
+
+// Полнотекстовый поиск по сообщениям журнала (LogFilter::search_query,
+// LogDAO::search_messages). Конфигурация simple не отбрасывает стоп-слова и не
+// приводит слова к основе: адреса почты и имена контроллеров ищутся как есть.
+// Вычисляемый столбец и индекс создаются на всех секциях.
+void add_log_message_search(pqxx::work& txn) {
+    txn.exec(
+        "ALTER TABLE system_log ADD COLUMN message_tsv tsvector "
+        "GENERATED ALWAYS AS (to_tsvector('simple', message)) STORED"
+    );
+    txn.exec("CREATE INDEX idx_system_log_message_tsv ON system_log USING GIN (message_tsv)");
+}
+
+// Индексы под запросы LogDAO::find_by_*: равенство по столбцу и сортировка по
+// времени читаются одним проходом индекса без сортировки. Индекс по actor_id и
+// subject_id заодно ускоряет ON DELETE SET NULL при удалении пользователя.
+// BRIN по времени - несколько страниц на секцию для диапазонных выборок по
+// журналу, в который записи только дописываются. Проверка - команда check-indexes.
+void add_log_access_indexes(pqxx::work& txn) {
+    txn.exec("CREATE INDEX idx_system_log_actor_timestamp ON system_log(actor_id, timestamp DESC)");
+    txn.exec("CREATE INDEX idx_system_log_subject_timestamp ON system_log(subject_id, timestamp DESC)");
+    txn.exec("CREATE INDEX idx_system_log_action_timestamp ON system_log(action_type, timestamp DESC)");
+    txn.exec("CREATE INDEX idx_system_log_ip_timestamp ON system_log(ip_address, timestamp DESC)");
+    // Составной индекс заменяет индекс только по уровню
+    txn.exec("CREATE INDEX idx_system_log_level_timestamp ON system_log(level, timestamp)");
+    txn.exec("DROP INDEX IF EXISTS idx_system_log_level");
+    txn.exec("CREATE INDEX idx_system_log_timestamp_brin ON system_log USING BRIN (timestamp)");
+}
+
+// Поправки счётчиков журнала только дописываются (см. LogDAO::fold_rollups):
+// вставка записи не держит до фиксации блокировку общей строки system_log_rollup.
+// system_log_counts - счётчики вместе с ещё не перенесёнными поправками.
+void add_log_rollup_deltas(pqxx::work& txn) {
+    txn.exec(
+        "CREATE TABLE system_log_rollup_delta ("
+        "bucket TIMESTAMP NOT NULL,"
+        "level VARCHAR(10) NOT NULL,"
+        "action_type VARCHAR(50) NOT NULL,"
+        "count BIGINT NOT NULL"
+        ")"
+    );
+    txn.exec(
+        "CREATE VIEW system_log_counts AS "
+        "SELECT bucket, granularity::text AS granularity, level, action_type, count FROM system_log_rollup "
+        "UNION ALL "
+        "SELECT bucket, 'hour', level, action_type, count FROM system_log_rollup_delta"
+    );
+}
+
+// Снимает сессионную advisory-блокировку при любом выходе из run()
+class AdvisoryLock {
+public:
+    explicit AdvisoryLock(pqxx::connection& conn) : conn_(conn) {
+        pqxx::nontransaction txn(conn_);
+        txn.exec(std::string("SELECT pg_advisory_lock(") + LOCK_KEY_SQL + ")");
+    }
+
+    ~AdvisoryLock() {
+        try {
+            pqxx::nontransaction txn(conn_);
+            txn.exec(std::string("SELECT pg_advisory_unlock(") + LOCK_KEY_SQL + ")");
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to release migration lock: " << e.what() << std::endl;
+        }
+    }
+
+    AdvisoryLock(const AdvisoryLock&) = delete;
+    AdvisoryLock& operator=(const AdvisoryLock&) = delete;
+
+private:
+    pqxx::connection& conn_;
+};
+} // namespace
+
+MigrationRunner::MigrationRunner(std::shared_ptr<ConnectionPool> pool)
+    : pool_(std::move(pool)) {}
+
+const std::vector<Migration>& MigrationRunner::migrations() {
+    static const std::vector<Migration> list = {
+        {1, "initial schema", create_initial_schema},
+        {2, "system permissions and roles", seed_system_permissions},
+        {3, "monthly partitions for system_log", partition_system_log},
+        {4, "revoked session subjects", create_revoked_subject},
+        {5, "hourly log rollups", create_log_rollup},
+        {6, "full-text search over log messages", add_log_message_search},
+        {7, "log access path indexes", add_log_access_indexes},
+        {8, "append-only log rollup deltas", add_log_rollup_deltas},
+    };
+    return list;
+}
+
+int MigrationRunner::latest_version() {
+    return migrations().empty() ? 0 : migrations().back().version;
+}
+
+// 0, если таблицы schema_version ещё нет
+int MigrationRunner::read_version(pqxx::connection& conn) {
+    try {
+        pqxx::nontransaction txn(conn);
+        return txn.query_value<int>("SELECT COALESCE(MAX(version), 0) FROM schema_version");
+    } catch (const pqxx::undefined_table&) {
+        return 0;
+    }
+}
+
+int MigrationRunner::current_version() {
+    try {
+        auto conn = pool_->acquire();
+        return read_version(*conn);
+    } catch (const std::exception& e) {
+        std::cerr << "Error in MigrationRunner::current_version: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+MigrationReport MigrationRunner::run() {
+    MigrationReport report;
+    try {
+        auto conn = pool_->acquire();
+
+        report.version_before = read_version(*conn);
+        report.version_after = report.version_before;
+        if (report.version_before >= latest_version()) {
+            report.success = true;
+            return report;
+        }
+
+        AdvisoryLock lock(*conn);
+        {
+            pqxx::work txn(*conn);
+            txn.exec(
+                "CREATE TABLE IF NOT EXISTS schema_version ("
+                "version INTEGER PRIMARY KEY,"
+                "description TEXT NOT NULL,"
+                "applied_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP"
+                ")"
+            );
+            txn.commit();
+        }
+
+        // Пока ждали блокировку, другой экземпляр мог уже всё применить
+        int version = read_version(*conn);
+        report.version_before = version;
+
+        for (const auto& migration : migrations()) {
+            if (migration.version <= version) {
+                continue;
+            }
+
+            // Каждая миграция - отдельная транзакция вместе с записью о её версии
+            pqxx::work txn(*conn);
+            migration.apply(txn);
+            txn.exec_params(
+                "INSERT INTO schema_version (version, description) VALUES ($1, $2)",
+                migration.version, migration.description
+            );
+            txn.commit();
+
+            version = migration.version;
+            report.version_after = version;
+            ++report.applied;
+            std::cout << "Applied migration " << migration.version << ": "
+                      << migration.description << std::endl;
+        }
+
+        report.success = true;
+    } catch (const std::exception& e) {
+        std::cerr << "Migration failed: " << e.what() << std::endl;
+    }
+    return report;
+}
+
+} // namespace db
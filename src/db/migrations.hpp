@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+#include "connection_pool.hpp"
+
+namespace db {
+
+// Шаг изменения схемы. Версии идут по возрастанию без пропусков,
+// применённый шаг никогда не меняется - исправления оформляются новым шагом.
+struct Migration {
+    int version;
+    std::string description;
+    std::function<void(pqxx::work&)> apply;
+};
+
+struct MigrationReport {
+    bool success = false;
+    int version_before = 0;
+    int version_after = 0;
+    size_t applied = 0;
+};
+
+// Применяет недостающие миграции. Если схема актуальна, всё сводится к одному
+// запросу версии; иначе миграции выполняются под advisory-блокировкой, чтобы
+// одновременно запущенные экземпляры не применяли их дважды.
+class MigrationRunner {
+public:
+    explicit MigrationRunner(std::shared_ptr<ConnectionPool> pool);
+
+    MigrationReport run();
+    int current_version();
+
+    static const std::vector<Migration>& migrations();
+    static int latest_version();
+
+private:
+    std::shared_ptr<ConnectionPool> pool_;
+
+    static int read_version(pqxx::connection& conn);
+};
+
+} // namespace db
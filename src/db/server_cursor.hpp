@@ -0,0 +1,35 @@
+#pragma once
+#include <algorithm>
+#include <string>
+#include <pqxx/pqxx>
+
+namespace db {
+
+// Выполняет запрос через серверный курсор (DECLARE/FETCH) и передаёт строки
+// порциями по batch_size: в памяти клиента одновременно только одна порция, а
+// первая порция приходит до того, как сервер дочитает весь результат.
+// on_batch(const pqxx::result&) возвращает false, чтобы прекратить чтение.
+// Курсор живёт до конца транзакции, поэтому txn не должна быть AUTOCOMMIT.
+template <typename OnBatch>
+size_t for_each_batch(pqxx::transaction_base& txn, const std::string& cursor_name,
+                      const std::string& query, const pqxx::params& params,
+                      size_t batch_size, OnBatch&& on_batch) {
+    batch_size = std::max<size_t>(batch_size, 1);
+    const std::string cursor = txn.quote_name(cursor_name);
+    txn.exec_params("DECLARE " + cursor + " NO SCROLL CURSOR FOR " + query, params);
+
+    const std::string fetch = "FETCH FORWARD " + std::to_string(batch_size) + " FROM " + cursor;
+    size_t rows = 0;
+    while (true) {
+        auto batch = txn.exec(fetch);
+        rows += batch.size();
+        if (batch.empty() || !on_batch(batch) || batch.size() < batch_size) {
+            break;
+        }
+    }
+
+    txn.exec("CLOSE " + cursor);
+    return rows;
+}
+
+} // namespace db
@@ -0,0 +1,49 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <pqxx/pqxx>
+
+namespace db {
+
+// Каталог подготовленных запросов. DAO регистрируют свои запросы при статической
+// инициализации, а пул соединений готовит их на каждом новом соединении.
+class StatementCatalog {
+public:
+    static void register_statement(const std::string &name, const std::string &sql) {
+        for (auto &entry : get_registry()) {
+            if (entry.first == name) {
+                entry.second = sql;
+                return;
+            }
+        }
+        get_registry().emplace_back(name, sql);
+    }
+
+    static void prepare_all(pqxx::connection &conn) {
+        // Повторная подготовка на том же соединении: сбрасываем старые версии
+        {
+            pqxx::nontransaction txn(conn);
+            txn.exec("DEALLOCATE ALL");
+        }
+        for (const auto &[name, sql] : get_registry()) {
+            try {
+                conn.prepare(name, sql);
+            } catch (const std::exception &e) {
+                std::cerr << "Failed to prepare statement " << name << ": " << e.what() << std::endl;
+                throw;
+            }
+        }
+    }
+
+    static size_t size() { return get_registry().size(); }
+
+private:
+    static std::vector<std::pair<std::string, std::string>> &get_registry() {
+        static std::vector<std::pair<std::string, std::string>> registry;
+        return registry;
+    }
+};
+
+} // namespace db
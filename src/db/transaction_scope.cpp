@@ -0,0 +1,101 @@
+#include "transaction_scope.hpp"
+#include <iostream>
+#include <stdexcept>
+
+namespace db {
+
+namespace {
+thread_local BatchTransaction* active_batch = nullptr;
+} // namespace
+
+BatchTransaction::BatchTransaction(std::shared_ptr<ConnectionPool> pool)
+    : pool_(std::move(pool)), connection_(pool_->acquire()), previous_(active_batch) {
+    if (active(pool_.get())) {
+        throw std::logic_error("BatchTransaction is already active on this thread");
+    }
+    work_ = std::make_unique<pqxx::work>(*connection_);
+    stack_.push_back(work_.get());
+    active_batch = this;
+}
+
+BatchTransaction::~BatchTransaction() {
+    try {
+        abort();
+    } catch (const std::exception& e) {
+        std::cerr << "Error in BatchTransaction::abort: " << e.what() << std::endl;
+    }
+}
+
+void BatchTransaction::commit() {
+    if (!work_) {
+        return;
+    }
+    finish();
+    work_->commit();
+    work_.reset();
+}
+
+void BatchTransaction::abort() {
+    if (!work_) {
+        return;
+    }
+    finish();
+    work_->abort();
+    work_.reset();
+}
+
+void BatchTransaction::finish() {
+    if (stack_.size() > 1) {
+        throw std::logic_error("BatchTransaction finished while a Work is still open");
+    }
+    stack_.clear();
+    if (active_batch == this) {
+        active_batch = previous_;
+    }
+}
+
+BatchTransaction* BatchTransaction::active(const ConnectionPool* pool) {
+    for (auto* batch = active_batch; batch != nullptr; batch = batch->previous_) {
+        if (batch->pool_.get() == pool) {
+            return batch;
+        }
+    }
+    return nullptr;
+}
+
+Work::Work(PooledConnection& conn, Mode mode) {
+    auto* batch = active_batch;
+    while (batch != nullptr && batch->connection_.get() != conn.get()) {
+        batch = batch->previous_;
+    }
+
+    if (batch != nullptr && !batch->stack_.empty()) {
+        auto savepoint = std::make_unique<pqxx::subtransaction>(*batch->stack_.back());
+        batch->stack_.push_back(savepoint.get());
+        txn_ = std::move(savepoint);
+        batch_ = batch;
+        return;
+    }
+
+    switch (mode) {
+        case Mode::READ_ONLY:
+            txn_ = std::make_unique<pqxx::read_transaction>(*conn);
+            break;
+        case Mode::AUTOCOMMIT:
+            txn_ = std::make_unique<pqxx::nontransaction>(*conn);
+            break;
+        default:
+            txn_ = std::make_unique<pqxx::work>(*conn);
+            break;
+    }
+}
+
+Work::~Work() {
+    // Незафиксированная точка сохранения откатывается в деструкторе subtransaction
+    txn_.reset();
+    if (batch_ != nullptr) {
+        batch_->stack_.pop_back();
+    }
+}
+
+} // namespace db
@@ -0,0 +1,64 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <pqxx/pqxx>
+#include "connection_pool.hpp"
+
+namespace db {
+
+// Общая транзакция для последовательности операций DAO на текущем потоке.
+// Пока объект жив, ConnectionPool::acquire() на этом потоке отдаёт его
+// соединение, а каждая db::Work становится точкой сохранения внутри него:
+// ошибка одной операции откатывает только её. Без commit() всё откатывается.
+class BatchTransaction {
+public:
+    explicit BatchTransaction(std::shared_ptr<ConnectionPool> pool);
+    ~BatchTransaction();
+
+    BatchTransaction(const BatchTransaction&) = delete;
+    BatchTransaction& operator=(const BatchTransaction&) = delete;
+
+    void commit();
+    void abort();
+
+    // Активная на этом потоке пакетная транзакция пула или nullptr
+    static BatchTransaction* active(const ConnectionPool* pool);
+
+private:
+    friend class Work;
+    friend class ConnectionPool;
+
+    std::shared_ptr<ConnectionPool> pool_;
+    PooledConnection connection_;
+    std::unique_ptr<pqxx::work> work_;
+    // Открытые точки сохранения: вложенная Work открывается внутри верхней
+    std::vector<pqxx::dbtransaction*> stack_;
+    BatchTransaction* previous_;
+
+    void finish();
+};
+
+// Транзакция одной операции DAO. Вне BatchTransaction - обычная транзакция
+// выбранного вида на соединении, внутри - точка сохранения пакетной.
+class Work {
+public:
+    enum class Mode {
+        READ_WRITE,
+        READ_ONLY,
+        AUTOCOMMIT // без BEGIN/COMMIT: одиночные запросы за один обмен с сервером
+    };
+
+    explicit Work(PooledConnection& conn, Mode mode = Mode::READ_WRITE);
+    ~Work();
+
+    Work(const Work&) = delete;
+    Work& operator=(const Work&) = delete;
+
+    pqxx::transaction_base& get() { return *txn_; }
+
+private:
+    std::unique_ptr<pqxx::transaction_base> txn_;
+    BatchTransaction* batch_ = nullptr;
+};
+
+} // namespace db
@@ -0,0 +1,52 @@
+#include "uuid_columns.hpp"
+
+namespace db {
+
+namespace {
+bool user_id_is_uuid(pqxx::transaction_base& txn) {
+    auto type = txn.exec1(
+        "SELECT format_type(atttypid, NULL) FROM pg_attribute "
+        "WHERE attrelid = 'app_user'::regclass AND attname = 'id'");
+    return type[0].as<std::string>() == "uuid";
+}
+} // namespace
+
+std::string user_id_column_type(pqxx::transaction_base& txn) {
+    return user_id_is_uuid(txn) ? "uuid" : "text";
+}
+
+bool convert_ids_to_uuid(pqxx::transaction_base& txn) {
+    // Второй экземпляр дождётся блокировки и увидит уже изменённый тип
+    txn.exec("LOCK TABLE app_user IN ACCESS EXCLUSIVE MODE");
+    if (user_id_is_uuid(txn)) {
+        return false;
+    }
+
+    // Внешний ключ не связывает столбцы разных типов: снимаем и создаём заново
+    txn.exec("ALTER TABLE user_role_assignment DROP CONSTRAINT IF EXISTS user_role_assignment_user_id_fkey");
+    txn.exec("ALTER TABLE system_log DROP CONSTRAINT IF EXISTS system_log_actor_id_fkey");
+    txn.exec("ALTER TABLE system_log DROP CONSTRAINT IF EXISTS system_log_subject_id_fkey");
+
+    // Значения, не являющиеся UUID, прерывают преобразование целиком
+    txn.exec("ALTER TABLE app_user ALTER COLUMN id TYPE uuid USING id::uuid");
+    txn.exec("ALTER TABLE user_role_assignment ALTER COLUMN user_id TYPE uuid USING user_id::uuid");
+    txn.exec(
+        "ALTER TABLE system_log "
+        "ALTER COLUMN id TYPE uuid USING id::uuid, "
+        "ALTER COLUMN actor_id TYPE uuid USING actor_id::uuid, "
+        "ALTER COLUMN subject_id TYPE uuid USING subject_id::uuid");
+    txn.exec("ALTER TABLE revoked_subject ALTER COLUMN subject_id TYPE uuid USING subject_id::uuid");
+
+    txn.exec(
+        "ALTER TABLE user_role_assignment ADD CONSTRAINT user_role_assignment_user_id_fkey "
+        "FOREIGN KEY (user_id) REFERENCES app_user(id) ON DELETE CASCADE");
+    txn.exec(
+        "ALTER TABLE system_log ADD CONSTRAINT system_log_actor_id_fkey "
+        "FOREIGN KEY (actor_id) REFERENCES app_user(id) ON DELETE SET NULL");
+    txn.exec(
+        "ALTER TABLE system_log ADD CONSTRAINT system_log_subject_id_fkey "
+        "FOREIGN KEY (subject_id) REFERENCES app_user(id) ON DELETE SET NULL");
+    return true;
+}
+
+} // namespace db
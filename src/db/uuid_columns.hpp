@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <pqxx/pqxx>
+
+namespace db {
+
+// Идентификаторы пользователей и записей журнала по умолчанию хранятся как
+// VARCHAR(36). convert_ids_to_uuid переводит app_user.id, system_log.id и все
+// ссылки на пользователя в родной тип uuid: ключ занимает 16 байт вместо 37.
+// Роли и разрешения не меняются - у системных ролей идентификаторы не UUID.
+
+// "uuid" после преобразования, иначе "text". Нужен временным таблицам, из
+// которых строки переносятся в app_user: text в uuid неявно не приводится.
+std::string user_id_column_type(pqxx::transaction_base& txn);
+
+// Повторный вызов ничего не меняет. Возвращает true, если столбцы изменены сейчас.
+bool convert_ids_to_uuid(pqxx::transaction_base& txn);
+
+} // namespace db
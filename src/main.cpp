@@ -1,3 +1,5 @@
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -8,11 +10,17 @@
 #include "./services/log_service.hpp"
 #include "./services/data_export_import_service.hpp"
 #include "./cli/cli_app.hpp"
+#include "./cli/non_interactive_io_handler.hpp"
 #include "./cli/standard_io_handler.hpp"
 
-std::shared_ptr<CliApp> create_cli_app() {
+// В пакетном режиме (batch_options != nullptr) ввод не запрашивается, а журнал
+// пишется синхронно: записи фиксируются в той же транзакции, что и изменения
+std::shared_ptr<CliApp> create_cli_app(BatchOptions* batch_options = nullptr) {
     try {
-        auto io_handler = std::make_shared<StandardIOHandler>();
+        std::shared_ptr<IOHandler> io_handler = std::make_shared<StandardIOHandler>();
+        if (batch_options) {
+            io_handler = std::make_shared<NonInteractiveIOHandler>(io_handler);
+        }
 
         auto db = db::Database::create(
             "postgres",
@@ -29,18 +37,46 @@ std::shared_ptr<CliApp> create_cli_app() {
             return nullptr;
         }
         
-        io_handler->println("Creating database schema...");
-        db->create_schema();
+        io_handler->println("Checking database schema...");
+        // APP_NATIVE_UUID_IDS=1 хранит идентификаторы пользователей и журнала как uuid
+        const char* native_uuid = std::getenv("APP_NATIVE_UUID_IDS");
+        if (!db->migrate(native_uuid != nullptr && std::string(native_uuid) == "1")) {
+            io_handler->error("Database schema migration: FAILED");
+            return nullptr;
+        }
         
         auto dao_factory = db::DAOFactory(db);
         auto user_dao = dao_factory.create_user_dao();
         auto log_dao = dao_factory.create_log_dao();
         auto permission_dao = dao_factory.create_permission_dao();
         auto data_export_import_dao = dao_factory.create_export_import_dao();
+        auto revocations = std::make_shared<services::RevocationList>(dao_factory.create_revocation_dao());
+        revocations->refresh();
+        revocations->start_watching();
+        log_dao->ensure_partitions();
+        log_dao->compact_rollups();
         
-        auto log_service = std::make_shared<services::LogService>(log_dao);
-        auto user_service = std::make_shared<services::UserService>(io_handler, user_dao, permission_dao, log_service);
-        auto auth_service = std::make_shared<services::AuthService>(user_dao, log_service);
+        services::AsyncLogWriterConfig log_writer_config;
+        log_writer_config.overflow_policy = services::OverflowPolicy::SPILL_TO_FILE;
+        std::shared_ptr<services::AsyncLogWriter> log_writer;
+        if (!batch_options) {
+            log_writer = std::make_shared<services::AsyncLogWriter>(log_dao, log_writer_config);
+        } else {
+            batch_options->pool = db->get_pool();
+        }
+        auto log_service = std::make_shared<services::LogService>(log_dao, log_writer);
+        auto hashing_pool = std::make_shared<utils::HashingWorkerPool>();
+        auto user_service = std::make_shared<services::UserService>(io_handler, user_dao, permission_dao, log_service,
+                                                                    revocations, hashing_pool);
+        // Без SESSION_TOKEN_KEY ключ случайный и токены действительны только в этом процессе
+        utils::SessionTokenConfig token_config;
+        if (const char* key = std::getenv("SESSION_TOKEN_KEY")) {
+            token_config.key = key;
+        }
+        auto token_signer = std::make_shared<utils::SessionTokenSigner>(token_config);
+        auto rate_limiter = std::make_shared<services::LoginRateLimiter>();
+        auto auth_service = std::make_shared<services::AuthService>(user_dao, log_service, hashing_pool, token_signer,
+                                                                    revocations, rate_limiter);
         auto data_export_import_service = std::make_shared<services::DataExportImportService>(data_export_import_dao, io_handler, log_service);
         
         user_service->initialize_system();
@@ -53,8 +89,76 @@ std::shared_ptr<CliApp> create_cli_app() {
     }
 }
 
-int main() {
+// Учётные данные пакетного режима: APP_BATCH_EMAIL и APP_BATCH_PASSWORD
+// или APP_BATCH_PASSWORD_FILE (пароль - первая строка файла)
+bool read_batch_credentials(BatchOptions& options) {
+    const char* email = std::getenv("APP_BATCH_EMAIL");
+    if (email == nullptr || *email == '\0') {
+        std::cerr << "❌ APP_BATCH_EMAIL is not set\n";
+        return false;
+    }
+    options.email = email;
+
+    if (const char* password = std::getenv("APP_BATCH_PASSWORD")) {
+        options.password = password;
+        return true;
+    }
+    if (const char* path = std::getenv("APP_BATCH_PASSWORD_FILE")) {
+        std::ifstream file(path);
+        if (file && std::getline(file, options.password)) {
+            return true;
+        }
+        std::cerr << "❌ Cannot read password file: " << path << "\n";
+        return false;
+    }
+    std::cerr << "❌ APP_BATCH_PASSWORD or APP_BATCH_PASSWORD_FILE is not set\n";
+    return false;
+}
+
+int run_batch(const std::string& script_path) {
+    BatchOptions options;
+    if (!read_batch_credentials(options)) {
+        return 1;
+    }
+
+    auto cli_app = create_cli_app(&options);
+    if (!cli_app) {
+        std::cerr << "❌ Failed to initialize CLI application\n";
+        return 1;
+    }
+
+    try {
+        BatchReport report;
+        if (script_path == "-") {
+            report = cli_app->RunBatch(std::cin, options);
+        } else {
+            std::ifstream script(script_path);
+            if (!script) {
+                std::cerr << "❌ Cannot open script: " << script_path << "\n";
+                return 1;
+            }
+            report = cli_app->RunBatch(script, options);
+        }
+        return report.authenticated && report.failed == 0 ? 0 : 2;
+    } catch (const std::exception& e) {
+        std::cerr << "💥 Critical error: " << e.what() << "\n";
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "🚀 Starting C++ PostgreSQL CLI Application...\n";
+
+    // --script <file> выполняет команды из файла, --batch - из stdin
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--script" && i + 1 < argc) {
+            return run_batch(argv[i + 1]);
+        }
+        if (arg == "--batch") {
+            return run_batch("-");
+        }
+    }
     
     try {
         auto cli_app = create_cli_app();
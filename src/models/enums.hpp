@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -52,9 +54,19 @@ enum class AccessPermissionType {
     SYSTEM_MANAGE_SETTINGS,
     PROFILE_READ,
     PROFILE_UPDATE,
-    PASSWORD_CHANGE
+    PASSWORD_CHANGE,
+    ROLE_READ,
+    LOG_READ,
+    LOG_EXPORT,
+    LOG_DELETE,
+    SYSTEM_BACKUP,
+    SYSTEM_RESTORE
 };
 
+// Число значений AccessPermissionType: размер битовой маски разрешений
+constexpr size_t ACCESS_PERMISSION_TYPE_COUNT =
+    static_cast<size_t>(AccessPermissionType::SYSTEM_RESTORE) + 1;
+
 inline std::string to_string(LogLevel level) {
     static const std::unordered_map<LogLevel, std::string> names = {
         {LogLevel::DEBUG, "DEBUG"},
@@ -110,7 +122,13 @@ inline std::string to_string(AccessPermissionType permission) {
         {AccessPermissionType::SYSTEM_MANAGE_SETTINGS, "SYSTEM_MANAGE_SETTINGS"},
         {AccessPermissionType::PROFILE_READ, "PROFILE_READ"},
         {AccessPermissionType::PROFILE_UPDATE, "PROFILE_UPDATE"},
-        {AccessPermissionType::PASSWORD_CHANGE, "PASSWORD_CHANGE"}
+        {AccessPermissionType::PASSWORD_CHANGE, "PASSWORD_CHANGE"},
+        {AccessPermissionType::ROLE_READ, "ROLE_READ"},
+        {AccessPermissionType::LOG_READ, "LOG_READ"},
+        {AccessPermissionType::LOG_EXPORT, "LOG_EXPORT"},
+        {AccessPermissionType::LOG_DELETE, "LOG_DELETE"},
+        {AccessPermissionType::SYSTEM_BACKUP, "SYSTEM_BACKUP"},
+        {AccessPermissionType::SYSTEM_RESTORE, "SYSTEM_RESTORE"}
     };
     return names.at(permission);
 }
@@ -215,5 +233,21 @@ inline std::optional<ActionType> string_to_action_type_optional(const std::strin
     return std::nullopt; 
 }
 
+inline std::optional<AccessPermissionType> string_to_permission_type_optional(const std::string& permission_str) {
+    static const std::unordered_map<std::string, AccessPermissionType> permission_map = [] {
+        std::unordered_map<std::string, AccessPermissionType> map;
+        for (size_t i = 0; i < ACCESS_PERMISSION_TYPE_COUNT; ++i) {
+            auto permission = static_cast<AccessPermissionType>(i);
+            map.emplace(to_string(permission), permission);
+        }
+        return map;
+    }();
+
+    auto it = permission_map.find(permission_str);
+    if (it != permission_map.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
 
 }
\ No newline at end of file
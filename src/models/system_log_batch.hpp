@@ -0,0 +1,96 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <pqxx/pqxx>
+#include "enums.hpp"
+#include "system_log.hpp"
+#include "../utils/string_arena.hpp"
+
+namespace models {
+
+// Запись журнала без владения строками: данные лежат в арене SystemLogBatch
+struct SystemLogView {
+    std::string_view id;
+    LogLevel level{};
+    ActionType action_type{};
+    std::string_view message;
+    std::string_view timestamp;
+    std::string_view actor_id;
+    std::string_view subject_id;
+    std::optional<std::string_view> ip_address;
+    std::optional<std::string_view> user_agent;
+
+    // Копия с владением, если запись нужна дольше пакета
+    SystemLog to_log() const {
+        SystemLog log(level, action_type, std::string(message));
+        log.set_id(std::string(id));
+        log.set_timestamp(std::string(timestamp));
+        log.set_actor_id(std::string(actor_id));
+        log.set_subject_id(std::string(subject_id));
+        if (ip_address) log.set_ip_address(std::string(*ip_address));
+        if (user_agent) log.set_user_agent(std::string(*user_agent));
+        return log;
+    }
+};
+
+// Результат выборки журнала одним непрерывным вектором: строки всех записей
+// копируются в общую арену, без shared_ptr и отдельных std::string на строку
+class SystemLogBatch {
+public:
+    SystemLogBatch() = default;
+    SystemLogBatch(SystemLogBatch&&) noexcept = default;
+    SystemLogBatch& operator=(SystemLogBatch&&) noexcept = default;
+    SystemLogBatch(const SystemLogBatch&) = delete;
+    SystemLogBatch& operator=(const SystemLogBatch&) = delete;
+
+    void append(const pqxx::result& result) {
+        if (result.empty()) {
+            return;
+        }
+        // Номера колонок ищутся один раз на результат, а не по имени в каждой строке
+        const auto id = result.column_number("id");
+        const auto level = result.column_number("level");
+        const auto action_type = result.column_number("action_type");
+        const auto message = result.column_number("message");
+        const auto timestamp = result.column_number("timestamp");
+        const auto actor_id = result.column_number("actor_id");
+        const auto subject_id = result.column_number("subject_id");
+        const auto ip_address = result.column_number("ip_address");
+        const auto user_agent = result.column_number("user_agent");
+
+        logs_.reserve(logs_.size() + result.size());
+        for (const auto& row : result) {
+            SystemLogView log;
+            log.id = arena_.store(row[id].view());
+            log.level = string_to_log_level(std::string(row[level].view()));
+            log.action_type = string_to_action_type(std::string(row[action_type].view()));
+            log.message = arena_.store(row[message].view());
+            log.timestamp = arena_.store(row[timestamp].view());
+            if (!row[actor_id].is_null()) log.actor_id = arena_.store(row[actor_id].view());
+            if (!row[subject_id].is_null()) log.subject_id = arena_.store(row[subject_id].view());
+            if (!row[ip_address].is_null()) log.ip_address = arena_.store(row[ip_address].view());
+            if (!row[user_agent].is_null()) log.user_agent = arena_.store(row[user_agent].view());
+            logs_.push_back(log);
+        }
+    }
+
+    size_t size() const { return logs_.size(); }
+    bool empty() const { return logs_.empty(); }
+    const SystemLogView& operator[](size_t index) const { return logs_[index]; }
+    const SystemLogView& back() const { return logs_.back(); }
+    // Строки удалённой записи остаются в арене до уничтожения пакета
+    void pop_back() { logs_.pop_back(); }
+
+    std::vector<SystemLogView>::const_iterator begin() const { return logs_.begin(); }
+    std::vector<SystemLogView>::const_iterator end() const { return logs_.end(); }
+
+    size_t arena_bytes() const { return arena_.bytes_used(); }
+
+private:
+    utils::StringArena arena_;
+    std::vector<SystemLogView> logs_;
+};
+
+} // namespace models
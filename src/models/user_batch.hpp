@@ -0,0 +1,84 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <pqxx/pqxx>
+#include "../utils/string_arena.hpp"
+
+namespace models {
+
+// Пользователь без владения строками: данные лежат в арене UserBatch.
+// Хэш пароля не выбирается - пакет предназначен для просмотра и выгрузки.
+struct UserView {
+    std::string_view id;
+    std::string_view first_name;
+    std::string_view last_name;
+    std::optional<std::string_view> patronymic;
+    std::string_view email;
+    std::optional<std::string_view> phone;
+    bool is_active = false;
+    bool password_change_required = false;
+    std::string_view created_at;
+    std::string_view updated_at;
+    std::optional<std::string_view> last_login_at;
+};
+
+// Список пользователей одним непрерывным вектором со строками в общей арене
+class UserBatch {
+public:
+    UserBatch() = default;
+    UserBatch(UserBatch&&) noexcept = default;
+    UserBatch& operator=(UserBatch&&) noexcept = default;
+    UserBatch(const UserBatch&) = delete;
+    UserBatch& operator=(const UserBatch&) = delete;
+
+    void append(const pqxx::result& result) {
+        if (result.empty()) {
+            return;
+        }
+        const auto id = result.column_number("id");
+        const auto first_name = result.column_number("first_name");
+        const auto last_name = result.column_number("last_name");
+        const auto patronymic = result.column_number("patronymic");
+        const auto email = result.column_number("email");
+        const auto phone = result.column_number("phone");
+        const auto is_active = result.column_number("is_active");
+        const auto password_change_required = result.column_number("password_change_required");
+        const auto created_at = result.column_number("created_at");
+        const auto updated_at = result.column_number("updated_at");
+        const auto last_login_at = result.column_number("last_login_at");
+
+        users_.reserve(users_.size() + result.size());
+        for (const auto& row : result) {
+            UserView user;
+            user.id = arena_.store(row[id].view());
+            user.first_name = arena_.store(row[first_name].view());
+            user.last_name = arena_.store(row[last_name].view());
+            if (!row[patronymic].is_null()) user.patronymic = arena_.store(row[patronymic].view());
+            user.email = arena_.store(row[email].view());
+            if (!row[phone].is_null()) user.phone = arena_.store(row[phone].view());
+            user.is_active = row[is_active].as<bool>();
+            user.password_change_required = row[password_change_required].as<bool>();
+            user.created_at = arena_.store(row[created_at].view());
+            user.updated_at = arena_.store(row[updated_at].view());
+            if (!row[last_login_at].is_null()) user.last_login_at = arena_.store(row[last_login_at].view());
+            users_.push_back(user);
+        }
+    }
+
+    size_t size() const { return users_.size(); }
+    bool empty() const { return users_.empty(); }
+    const UserView& operator[](size_t index) const { return users_[index]; }
+
+    std::vector<UserView>::const_iterator begin() const { return users_.begin(); }
+    std::vector<UserView>::const_iterator end() const { return users_.end(); }
+
+    size_t arena_bytes() const { return arena_.bytes_used(); }
+
+private:
+    utils::StringArena arena_;
+    std::vector<UserView> users_;
+};
+
+} // namespace models
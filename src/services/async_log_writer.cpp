@@ -0,0 +1,382 @@
+#include "async_log_writer.hpp"
+#include "src/models/enums.hpp"
+#include "src/utils/uuid_generator.hpp"
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace services {
+
+namespace {
+// Формат spill-файла: одна запись на строку, поля через табуляцию.
+// \t, \n, \r и \ экранируются, отсутствующее значение записывается как \N.
+const char* SPILL_NULL = "\\N";
+
+std::string escape_field(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+        case '\\': out += "\\\\"; break;
+        case '\t': out += "\\t"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        default: out += c;
+        }
+    }
+    return out;
+}
+
+std::string unescape_field(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '\\' || i + 1 == value.size()) {
+            out += value[i];
+            continue;
+        }
+        char next = value[++i];
+        switch (next) {
+        case 't': out += '\t'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        default: out += next;
+        }
+    }
+    return out;
+}
+
+std::string optional_field(const std::optional<std::string>& value) {
+    return value ? escape_field(*value) : SPILL_NULL;
+}
+
+std::optional<std::string> parse_optional_field(const std::string& value) {
+    if (value == SPILL_NULL) {
+        return std::nullopt;
+    }
+    return unescape_field(value);
+}
+
+std::shared_ptr<models::SystemLog> parse_spill_line(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+        if (tab == std::string::npos) {
+            break;
+        }
+        start = tab + 1;
+    }
+    if (fields.size() != 9) {
+        return nullptr;
+    }
+
+    auto log = std::make_shared<models::SystemLog>();
+    log->set_id(unescape_field(fields[0]));
+    log->set_level(models::string_to_log_level(fields[1]));
+    log->set_action_type(models::string_to_action_type(fields[2]));
+    log->set_timestamp(unescape_field(fields[3]));
+    log->set_actor_id(unescape_field(fields[4]));
+    log->set_subject_id(unescape_field(fields[5]));
+    log->set_ip_address(parse_optional_field(fields[6]));
+    log->set_user_agent(parse_optional_field(fields[7]));
+    log->set_message(unescape_field(fields[8]));
+    return log;
+}
+} // namespace
+
+AsyncLogWriter::AsyncLogWriter(std::shared_ptr<dao::LogDAO> log_dao, AsyncLogWriterConfig config)
+    : log_dao_(std::move(log_dao)),
+      config_(std::move(config)),
+      queue_(config_.queue_capacity) {
+    if (config_.batch_size == 0) {
+        config_.batch_size = 1;
+    }
+    worker_ = std::thread(&AsyncLogWriter::run, this);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    shutdown();
+}
+
+bool AsyncLogWriter::enqueue(std::shared_ptr<models::SystemLog> entry) {
+    if (!entry) {
+        return false;
+    }
+
+    ++producers_;
+    if (!accepting_.load()) {
+        --producers_;
+        return false;
+    }
+
+    if (entry->id().empty()) {
+        entry->set_id(utils::UUIDGenerator::generate_uuid());
+    }
+    if (entry->timestamp().empty()) {
+        entry->set_timestamp(format_timestamp(std::chrono::system_clock::now()));
+    }
+
+    if (config_.overflow_policy == OverflowPolicy::DROP_DEBUG_FIRST &&
+        entry->level() == models::LogLevel::DEBUG &&
+        queue_.size_approx() >= static_cast<size_t>(config_.debug_watermark * queue_.capacity())) {
+        ++dropped_;
+        --producers_;
+        return false;
+    }
+
+    // Каждая принятая запись ровно один раз учитывается в processed_
+    ++accepted_;
+    bool queued = queue_.try_push(std::move(entry));
+    if (!queued) {
+        if (config_.overflow_policy == OverflowPolicy::SPILL_TO_FILE) {
+            spill({entry});
+            ++processed_;
+        } else {
+            queued = push_blocking(entry);
+        }
+    }
+
+    if (queued && queue_.size_approx() >= config_.batch_size) {
+        wake_worker();
+    }
+    --producers_;
+    return true;
+}
+
+bool AsyncLogWriter::push_blocking(Entry& entry) {
+    ++blocked_enqueues_;
+    while (true) {
+        wake_worker();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        if (queue_.try_push(std::move(entry))) {
+            return true;
+        }
+    }
+}
+
+void AsyncLogWriter::wake_worker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_requested_ = true;
+    }
+    wake_.notify_one();
+}
+
+void AsyncLogWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait_for(lock, config_.flush_interval, [this] {
+            return stopping_ || flush_requested_;
+        });
+        bool stopping = stopping_;
+        flush_requested_ = false;
+        lock.unlock();
+
+        drain();
+        replay_spill();
+        fold_rollups();
+
+        lock.lock();
+        flushed_.notify_all();
+        if (stopping && queue_.size_approx() == 0) {
+            break;
+        }
+    }
+    stopped_ = true;
+    flushed_.notify_all();
+}
+
+void AsyncLogWriter::drain() {
+    std::vector<Entry> batch;
+    batch.reserve(config_.batch_size);
+
+    Entry entry;
+    while (queue_.try_pop(entry)) {
+        batch.push_back(std::move(entry));
+        if (batch.size() >= config_.batch_size) {
+            space_.notify_all();
+            write_batch(batch);
+        }
+    }
+    space_.notify_all();
+    if (!batch.empty()) {
+        write_batch(batch);
+    }
+}
+
+// Отдельная короткая транзакция: строки счётчиков не блокируются на время
+// чужих транзакций, пишущих журнал
+void AsyncLogWriter::fold_rollups() {
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_fold_) {
+        return;
+    }
+    log_dao_->fold_rollups();
+    next_fold_ = now + config_.rollup_fold_interval;
+}
+
+void AsyncLogWriter::write_batch(std::vector<Entry>& batch) {
+    const size_t count = batch.size();
+    if (log_dao_->save_batch(batch)) {
+        written_ += count;
+    } else {
+        ++failed_batches_;
+        if (config_.overflow_policy == OverflowPolicy::SPILL_TO_FILE) {
+            spill(batch);
+        } else {
+            dropped_ += count;
+            std::cerr << "Audit log: lost batch of " << count << " entries" << std::endl;
+        }
+    }
+    processed_ += count;
+    batch.clear();
+}
+
+void AsyncLogWriter::spill(const std::vector<Entry>& entries) {
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+    std::ofstream file(config_.spill_path, std::ios::app);
+    if (!file.is_open()) {
+        dropped_ += entries.size();
+        std::cerr << "Audit log: cannot open spill file " << config_.spill_path << std::endl;
+        return;
+    }
+
+    for (const auto& log : entries) {
+        file << escape_field(log->id()) << '\t'
+             << log->level_string() << '\t'
+             << log->action_type_string() << '\t'
+             << escape_field(log->timestamp()) << '\t'
+             << escape_field(log->actor_id()) << '\t'
+             << escape_field(log->subject_id()) << '\t'
+             << optional_field(log->ip_address()) << '\t'
+             << optional_field(log->user_agent()) << '\t'
+             << escape_field(log->message()) << '\n';
+    }
+    spilled_ += entries.size();
+}
+
+// Загружает в БД записи, ранее сброшенные в spill-файл. Файл переименовывается,
+// чтобы новые записи при переполнении не смешивались с загружаемыми.
+void AsyncLogWriter::replay_spill() {
+    namespace fs = std::filesystem;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_replay_) {
+        return;
+    }
+
+    const std::string replay_path = config_.spill_path + ".replay";
+    std::error_code ec;
+    {
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        if (!fs::exists(replay_path, ec)) {
+            if (!fs::exists(config_.spill_path, ec)) {
+                return;
+            }
+            fs::rename(config_.spill_path, replay_path, ec);
+            if (ec) {
+                std::cerr << "Audit log: cannot rotate spill file: " << ec.message() << std::endl;
+                next_replay_ = now + std::chrono::seconds(30);
+                return;
+            }
+        }
+    }
+
+    std::ifstream file(replay_path);
+    std::vector<Entry> batch;
+    std::string line;
+    size_t restored = 0;
+    bool ok = true;
+    while (ok && std::getline(file, line)) {
+        if (auto log = parse_spill_line(line)) {
+            batch.push_back(std::move(log));
+        }
+        if (batch.size() >= config_.batch_size) {
+            ok = log_dao_->save_batch(batch);
+            restored += ok ? batch.size() : 0;
+            batch.clear();
+        }
+    }
+    if (ok && !batch.empty()) {
+        ok = log_dao_->save_batch(batch);
+        restored += ok ? batch.size() : 0;
+    }
+    file.close();
+
+    // Повторная загрузка безопасна: save_batch игнорирует уже записанные id
+    if (ok) {
+        fs::remove(replay_path, ec);
+        replayed_ += restored;
+    } else {
+        std::cerr << "Audit log: spill replay failed, will retry" << std::endl;
+        next_replay_ = now + std::chrono::seconds(30);
+    }
+}
+
+void AsyncLogWriter::flush() {
+    const uint64_t target = accepted_.load();
+    wake_worker();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_ && processed_.load() < target) {
+        flushed_.wait_for(lock, config_.flush_interval);
+        if (processed_.load() < target) {
+            flush_requested_ = true;
+            wake_.notify_one();
+        }
+    }
+}
+
+void AsyncLogWriter::shutdown() {
+    accepting_ = false;
+    // Дожидаемся производителей, уже прошедших проверку accepting_
+    while (producers_.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+AsyncLogWriterStats AsyncLogWriter::stats() const {
+    AsyncLogWriterStats snapshot;
+    snapshot.enqueued = accepted_.load();
+    snapshot.written = written_.load();
+    snapshot.dropped = dropped_.load();
+    snapshot.spilled = spilled_.load();
+    snapshot.replayed = replayed_.load();
+    snapshot.failed_batches = failed_batches_.load();
+    snapshot.blocked_enqueues = blocked_enqueues_.load();
+    return snapshot;
+}
+
+// Время в UTC с явным смещением: БД приводит его к своему часовому поясу
+std::string AsyncLogWriter::format_timestamp(std::chrono::system_clock::time_point tp) {
+    auto seconds = std::chrono::time_point_cast<std::chrono::seconds>(tp);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(tp - seconds).count();
+    std::time_t time = std::chrono::system_clock::to_time_t(seconds);
+    std::tm tm{};
+    gmtime_r(&time, &tm);
+
+    std::ostringstream ss;
+    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << '.'
+       << std::setw(6) << std::setfill('0') << micros << "+00";
+    return ss.str();
+}
+
+} // namespace services
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "src/dao/log_dao.hpp"
+#include "src/models/system_log.hpp"
+#include "src/utils/bounded_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace services {
+
+// Что делать, когда очередь журнала заполнена
+enum class OverflowPolicy {
+    BLOCK,            // ждать, пока фоновый поток освободит место
+    DROP_DEBUG_FIRST, // DEBUG отбрасываются заранее, остальные уровни ждут
+    SPILL_TO_FILE     // дописать запись в локальный файл, он загрузится позже
+};
+
+struct AsyncLogWriterConfig {
+    size_t queue_capacity = 4096;
+    // Пакет уходит в БД, как только набралось столько записей...
+    size_t batch_size = 256;
+    // ...или по истечении этого интервала
+    std::chrono::milliseconds flush_interval{200};
+    OverflowPolicy overflow_policy = OverflowPolicy::BLOCK;
+    // DROP_DEBUG_FIRST: доля заполнения, начиная с которой DEBUG не принимаются
+    double debug_watermark = 0.75;
+    std::string spill_path = "audit_log.spill";
+    // Как часто поправки счётчиков журнала переносятся в system_log_rollup
+    std::chrono::milliseconds rollup_fold_interval{5000};
+};
+
+struct AsyncLogWriterStats {
+    uint64_t enqueued = 0;
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    uint64_t spilled = 0;
+    uint64_t replayed = 0;
+    uint64_t failed_batches = 0;
+    uint64_t blocked_enqueues = 0;
+};
+
+// Фоновая пакетная запись журнала аудита. Записи, принятые до shutdown(),
+// гарантированно записываются в БД (или в spill-файл) до его завершения.
+class AsyncLogWriter {
+public:
+    explicit AsyncLogWriter(std::shared_ptr<dao::LogDAO> log_dao, AsyncLogWriterConfig config = {});
+    ~AsyncLogWriter();
+
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+    // false, если запись отброшена по политике переполнения или writer остановлен
+    bool enqueue(std::shared_ptr<models::SystemLog> entry);
+
+    // Блокирует, пока не будут записаны все записи, принятые до вызова
+    void flush();
+    void shutdown();
+
+    AsyncLogWriterStats stats() const;
+    const AsyncLogWriterConfig& config() const { return config_; }
+
+private:
+    using Entry = std::shared_ptr<models::SystemLog>;
+
+    void run();
+    void drain();
+    void write_batch(std::vector<Entry>& batch);
+    bool push_blocking(Entry& entry);
+    void spill(const std::vector<Entry>& entries);
+    void replay_spill();
+    void fold_rollups();
+    void wake_worker();
+
+    static std::string format_timestamp(std::chrono::system_clock::time_point tp);
+
+    std::shared_ptr<dao::LogDAO> log_dao_;
+    AsyncLogWriterConfig config_;
+    utils::BoundedQueue<Entry> queue_;
+
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable space_;
+    std::condition_variable flushed_;
+    bool flush_requested_ = false;
+    bool stopping_ = false;
+    bool stopped_ = false;
+
+    std::atomic<bool> accepting_{true};
+    std::atomic<int> producers_{0};
+
+    std::mutex spill_mutex_;
+    std::chrono::steady_clock::time_point next_replay_{};
+    // Только для фонового потока
+    std::chrono::steady_clock::time_point next_fold_{};
+
+    std::atomic<uint64_t> accepted_{0};
+    std::atomic<uint64_t> processed_{0};
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> spilled_{0};
+    std::atomic<uint64_t> replayed_{0};
+    std::atomic<uint64_t> failed_batches_{0};
+    std::atomic<uint64_t> blocked_enqueues_{0};
+};
+
+} // namespace services
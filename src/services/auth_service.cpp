@@ -8,17 +8,103 @@
 
 
 namespace services {
-AuthService::AuthService(std::shared_ptr<dao::UserDAO> user_dao, std::shared_ptr<services::LogService> log_service)
+AuthService::AuthService(std::shared_ptr<dao::UserDAO> user_dao, std::shared_ptr<services::LogService> log_service,
+                         std::shared_ptr<utils::HashingWorkerPool> hashing_pool,
+                         std::shared_ptr<utils::SessionTokenSigner> token_signer,
+                         std::shared_ptr<RevocationList> revocations,
+                         std::shared_ptr<LoginRateLimiter> rate_limiter)
     : user_dao_(std::move(user_dao)),
-    log_service_(std::move(log_service)) {}
+    log_service_(std::move(log_service)),
+    hashing_pool_(std::move(hashing_pool)),
+    token_signer_(std::move(token_signer)),
+    revocations_(std::move(revocations)),
+    rate_limiter_(std::move(rate_limiter)) {}
+
+utils::VerifyStatus AuthService::verify_password(const std::string &email,
+                                                 const std::string &password,
+                                                 const std::string &stored_hash) {
+    if (!hashing_pool_) {
+        return utils::PasswordUtils::verify_password_pbkdf2(password, stored_hash)
+                   ? utils::VerifyStatus::VERIFIED
+                   : utils::VerifyStatus::MISMATCH;
+    }
+    return hashing_pool_->verify_async(email, password, stored_hash).get();
+}
+
+std::optional<std::string> AuthService::hash_password(const std::string &email,
+                                                      const std::string &password) {
+    if (!hashing_pool_) {
+        return utils::PasswordUtils::hash_password_pbkdf2(password);
+    }
+    return hashing_pool_->hash_async(email, password).get();
+}
+
+void AuthService::revoke_sessions(const std::shared_ptr<models::User> &user, const std::string &reason) {
+    if (!revocations_) {
+        return;
+    }
+    if (!revocations_->revoke(user->id(), reason)) {
+        log_service_->error(models::ActionType::SECURITY_VIOLATION,
+                           "Failed to revoke sessions (" + reason + ") for user: " + user->email(),
+                           nullptr, user);
+    }
+}
+
+void AuthService::record_failure(const std::string &email) {
+    if (rate_limiter_) {
+        rate_limiter_->record_failure(email);
+    }
+}
+
+std::string AuthService::issue_token(const std::shared_ptr<models::User> &user,
+                                     const std::vector<std::string> &permission_names) const {
+    if (!token_signer_) {
+        return "";
+    }
+    uint64_t permissions = 0;
+    for (const auto &name : permission_names) {
+        if (auto type = models::string_to_permission_type_optional(name)) {
+            permissions |= uint64_t{1} << static_cast<size_t>(*type);
+        }
+    }
+    return token_signer_->issue(user->id(), permissions);
+}
+
+std::optional<utils::SessionClaims> AuthService::verify_token(const std::string &token) const {
+    if (!token_signer_) {
+        return std::nullopt;
+    }
+    auto claims = token_signer_->verify(token);
+    if (claims && revocations_ && revocations_->is_revoked(claims->user_id, claims->issued_at)) {
+        return std::nullopt;
+    }
+    return claims;
+}
 
 LoginResult AuthService::login(const std::string &email,
-                               const std::string &password) {
-    std::shared_ptr<models::User> user = user_dao_->find_by_email(email);
+                               const std::string &password,
+                               const std::string &source) {
+    // Перебор отсекается до запроса к БД и до PBKDF2
+    if (rate_limiter_) {
+        auto decision = rate_limiter_->check(email, source);
+        if (decision != ThrottleDecision::ALLOWED) {
+            log_service_->warning(models::ActionType::SECURITY_ACCESS_DENIED,
+                                 std::string("Login throttled - too many attempts from ") +
+                                     (decision == ThrottleDecision::EMAIL_BLOCKED ? "email: " + email
+                                                                                  : "source: " + source),
+                                 nullptr, nullptr, source, "CLI Client");
+            return {false, nullptr, false, "Too many login attempts, try again later"};
+        }
+    }
+
+    // Пользователь, роли и разрешения - одним запросом
+    auto profile = user_dao_->find_login_profile(email);
+    std::shared_ptr<models::User> user = profile.user;
     if (!user) {
         log_service_->error(models::ActionType::SYSTEM_LOGIN, 
                            "Failed login attempt - user not found: " + email,
                            nullptr, nullptr, "192.168.1.100", "CLI Client");
+        record_failure(email);
         return {false, nullptr, false, "User not found"};
     }
 
@@ -26,29 +112,51 @@ LoginResult AuthService::login(const std::string &email,
         log_service_->warning(models::ActionType::SECURITY_ACCESS_DENIED,
                              "Login attempt to inactive account: " + email,
                              nullptr, user, "192.168.1.100", "CLI Client");
+        record_failure(email);
         return {false, nullptr, false, "Account is inactive"};
     }
 
-    if (!utils::PasswordUtils::verify_password_pbkdf2(password,
-                                                      user->password_hash())) {
+    auto verification = verify_password(email, password, user->password_hash());
+    if (verification == utils::VerifyStatus::REJECTED) {
+        log_service_->warning(models::ActionType::SECURITY_ACCESS_DENIED,
+                             "Login attempt rejected - too many pending attempts: " + email,
+                             nullptr, user, "192.168.1.100", "CLI Client");
+        return {false, nullptr, false, "Too many login attempts, try again later"};
+    }
+
+    if (verification != utils::VerifyStatus::VERIFIED) {
         log_service_->warning(models::ActionType::SECURITY_ACCESS_DENIED,
                              "Invalid password for user: " + email,
                              nullptr, user, "192.168.1.100", "CLI Client");
+        record_failure(email);
         return {false, nullptr, false, "Invalid credentials"};
     }
 
+    if (rate_limiter_) {
+        rate_limiter_->record_success(email);
+    }
+
     if (user->is_password_change_required()) {
         log_service_->info(models::ActionType::SYSTEM_LOGIN,
                           "User login successful - password change required: " + email,
                           user, nullptr, "192.168.1.100", "CLI Client");
-        return {true, user, true, ""};
+        // Токен не выдаётся, пока пароль не сменён
+        return {true, user, true, "", profile.role_names, profile.permission_names};
+    }
+
+    // Время входа обновляется, только если пароль не сменили после чтения профиля
+    if (!user_dao_->record_login(user)) {
+        log_service_->warning(models::ActionType::SECURITY_ACCESS_DENIED,
+                             "Login aborted - credentials changed during login: " + email,
+                             nullptr, user, "192.168.1.100", "CLI Client");
+        return {false, nullptr, false, "Invalid credentials"};
     }
 
     log_service_->info(models::ActionType::SYSTEM_LOGIN,
                       "User login successful: " + email,
                       user, nullptr, "192.168.1.100", "CLI Client");
-    update_last_login(user);
-    return {true, user, false, ""};
+    return {true, user, false, "", profile.role_names, profile.permission_names,
+            issue_token(user, profile.permission_names)};
 }
 
 void AuthService::update_last_login(const std::shared_ptr<models::User> &user) {
@@ -105,11 +213,18 @@ bool AuthService::change_password(const std::string &email,
             return false;
         }
 
-        std::string new_password_hash =
-            utils::PasswordUtils::hash_password_pbkdf2(new_password);
+        auto new_password_hash = hash_password(email, new_password);
+        if (!new_password_hash) {
+            log_service_->warning(models::ActionType::SECURITY_PASSWORD_RESET,
+                                "Password change rejected - hashing pool is busy: " + email,
+                                nullptr, user, "192.168.1.100", "CLI Client");
+            return false;
+        }
 
-        bool success = user_dao_->change_password(user, new_password_hash);
+        bool success = user_dao_->change_password(user, *new_password_hash);
         if (success) {
+            // Сессии, открытые со старым паролем, больше недействительны
+            revoke_sessions(user, "password changed");
             log_service_->info(models::ActionType::USER_PASSWORD_CHANGED,
                              "Password changed successfully for user: " + email,
                              user, nullptr, "192.168.1.100", "CLI Client");
@@ -146,11 +261,18 @@ bool AuthService::change_password(const std::string &email,
             return false;
         }
 
-        std::string new_password_hash =
-            utils::PasswordUtils::hash_password_pbkdf2(new_password);
+        auto new_password_hash = hash_password(email, new_password);
+        if (!new_password_hash) {
+            log_service_->warning(models::ActionType::SECURITY_PASSWORD_RESET,
+                                "Password change rejected - hashing pool is busy: " + email,
+                                nullptr, user, "192.168.1.100", "CLI Client");
+            return false;
+        }
 
-        bool success = user_dao_->change_password(user, new_password_hash);
+        bool success = user_dao_->change_password(user, *new_password_hash);
         if (success) {
+            // Сессии, открытые со старым паролем, больше недействительны
+            revoke_sessions(user, "password changed");
             log_service_->info(models::ActionType::SECURITY_PASSWORD_RESET,
                              "Admin password reset successful for user: " + email,
                              nullptr, user, "192.168.1.100", "CLI Client");
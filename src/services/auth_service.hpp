@@ -1,10 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 #include "src/dao/user_dao.hpp"
 #include "src/models/user.hpp"
+#include "src/utils/hashing_worker_pool.hpp"
+#include "src/utils/session_token.hpp"
 #include "log_service.hpp"
+#include "login_rate_limiter.hpp"
+#include "revocation_list.hpp"
 
 namespace services {
 
@@ -13,28 +19,58 @@ struct LoginResult {
     std::shared_ptr<models::User> user;
     bool password_change_required;
     std::string message;
+    // Заполняются при успешном входе из того же запроса, что и пользователь
+    std::vector<std::string> role_names = {};
+    std::vector<std::string> permission_names = {};
+    // Подписанный токен сессии; пуст, если подписант не настроен
+    std::string session_token = {};
 };
 
 class AuthService {
 public:
-    explicit AuthService(std::shared_ptr<dao::UserDAO> user_dao, std::shared_ptr<services::LogService> log_service);
-    LoginResult login(const std::string &email, const std::string &password);
+    // Без hashing_pool PBKDF2 выполняется в вызывающем потоке
+    explicit AuthService(std::shared_ptr<dao::UserDAO> user_dao, std::shared_ptr<services::LogService> log_service,
+                         std::shared_ptr<utils::HashingWorkerPool> hashing_pool = nullptr,
+                         std::shared_ptr<utils::SessionTokenSigner> token_signer = nullptr,
+                         std::shared_ptr<RevocationList> revocations = nullptr,
+                         std::shared_ptr<LoginRateLimiter> rate_limiter = nullptr);
+    // source - откуда пришла попытка (адрес клиента); по нему считается лимит попыток
+    LoginResult login(const std::string &email, const std::string &password,
+                      const std::string &source = "local");
     bool authenticate(const std::string& email, const std::string& password);
     void logout();
     bool is_authenticated() const;
 
+    // Проверяет токен из LoginResult без обращения к базе, включая список отзыва
+    std::optional<utils::SessionClaims> verify_token(const std::string& token) const;
+
     bool change_password(const std::string& email, const std::string& old_password, const std::string& new_password);
     bool change_password(const std::string& email, const std::string& new_password);
 
 
     std::shared_ptr<models::User> get_current_user() const;
+    // nullptr, если ограничение попыток входа не настроено
+    std::shared_ptr<const LoginRateLimiter> rate_limiter() const { return rate_limiter_; }
 
     void update_last_login(const std::shared_ptr<models::User> &user);
 
 private:
+    utils::VerifyStatus verify_password(const std::string& email, const std::string& password,
+                                        const std::string& stored_hash);
+    std::optional<std::string> hash_password(const std::string& email, const std::string& password);
+    void record_failure(const std::string& email);
+    // Отзывает выданные пользователю токены сессии, если список отзыва подключён
+    void revoke_sessions(const std::shared_ptr<models::User>& user, const std::string& reason);
+    std::string issue_token(const std::shared_ptr<models::User>& user,
+                            const std::vector<std::string>& permission_names) const;
+
     std::shared_ptr<dao::UserDAO> user_dao_;
     std::shared_ptr<models::User> current_user_;
     std::shared_ptr<LogService> log_service_;
+    std::shared_ptr<utils::HashingWorkerPool> hashing_pool_;
+    std::shared_ptr<utils::SessionTokenSigner> token_signer_;
+    std::shared_ptr<RevocationList> revocations_;
+    std::shared_ptr<LoginRateLimiter> rate_limiter_;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "authorization_snapshot.hpp"
+#include <algorithm>
+
+namespace services {
+
+std::shared_ptr<const AuthorizationSnapshot>
+AuthorizationSnapshot::build(const dao::AuthorizationRows& rows) {
+    auto snapshot = std::make_shared<AuthorizationSnapshot>();
+    std::unordered_map<std::string, uint32_t> role_index;
+
+    for (const auto& entry : rows.role_permissions) {
+        auto [it, inserted] = role_index.emplace(entry.role_id, static_cast<uint32_t>(snapshot->roles_.size()));
+        if (inserted) {
+            snapshot->roles_.push_back({entry.role_name, {}, {}});
+        }
+        if (!entry.permission_name) {
+            continue;
+        }
+
+        Role& role = snapshot->roles_[it->second];
+        if (auto permission = models::string_to_permission_type_optional(*entry.permission_name)) {
+            role.permissions.set(static_cast<size_t>(*permission));
+        } else {
+            role.other_permissions.push_back(*entry.permission_name);
+        }
+    }
+
+    for (const auto& entry : rows.user_roles) {
+        auto it = role_index.find(entry.role_id);
+        if (it != role_index.end()) {
+            snapshot->user_roles_[entry.user_id].push_back(it->second);
+        }
+    }
+
+    return snapshot;
+}
+
+const std::vector<uint32_t>* AuthorizationSnapshot::roles_of(const std::string& user_id) const {
+    auto it = user_roles_.find(user_id);
+    return it == user_roles_.end() ? nullptr : &it->second;
+}
+
+PermissionSet AuthorizationSnapshot::permissions_of(const std::string& user_id) const {
+    PermissionSet result;
+    if (const auto* roles = roles_of(user_id)) {
+        for (uint32_t index : *roles) {
+            result |= roles_[index].permissions;
+        }
+    }
+    return result;
+}
+
+bool AuthorizationSnapshot::has_permission(const std::string& user_id,
+                                           models::AccessPermissionType permission) const {
+    return permissions_of(user_id).test(static_cast<size_t>(permission));
+}
+
+bool AuthorizationSnapshot::has_permission(const std::string& user_id,
+                                           const std::string& permission_name) const {
+    if (auto permission = models::string_to_permission_type_optional(permission_name)) {
+        return has_permission(user_id, *permission);
+    }
+
+    const auto* roles = roles_of(user_id);
+    if (!roles) {
+        return false;
+    }
+    for (uint32_t index : *roles) {
+        const auto& other = roles_[index].other_permissions;
+        if (std::find(other.begin(), other.end(), permission_name) != other.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AuthorizationSnapshot::has_role(const std::string& user_id, const std::string& role_name) const {
+    const auto* roles = roles_of(user_id);
+    if (!roles) {
+        return false;
+    }
+    return std::any_of(roles->begin(), roles->end(), [&](uint32_t index) {
+        return roles_[index].name == role_name;
+    });
+}
+
+std::vector<std::string> AuthorizationSnapshot::members_of(const std::string& role_name) const {
+    std::vector<std::string> members;
+    for (const auto& [user_id, roles] : user_roles_) {
+        if (std::any_of(roles.begin(), roles.end(),
+                        [&](uint32_t index) { return roles_[index].name == role_name; })) {
+            members.push_back(user_id);
+        }
+    }
+    return members;
+}
+
+std::vector<std::string> AuthorizationSnapshot::permission_names(const std::string& user_id) const {
+    std::vector<std::string> names;
+    PermissionSet permissions = permissions_of(user_id);
+    for (size_t i = 0; i < permissions.size(); ++i) {
+        if (permissions.test(i)) {
+            names.push_back(models::to_string(static_cast<models::AccessPermissionType>(i)));
+        }
+    }
+
+    if (const auto* roles = roles_of(user_id)) {
+        for (uint32_t index : *roles) {
+            const auto& other = roles_[index].other_permissions;
+            names.insert(names.end(), other.begin(), other.end());
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
+
+} // namespace services
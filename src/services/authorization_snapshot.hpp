@@ -0,0 +1,50 @@
+#pragma once
+
+#include "src/dao/access_permission_dao.hpp"
+#include "src/models/enums.hpp"
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace services {
+
+using PermissionSet = std::bitset<models::ACCESS_PERMISSION_TYPE_COUNT>;
+
+// Неизменяемый снимок RBAC: роли хранятся как битовые маски разрешений,
+// пользователи - как списки индексов ролей. Проверка прав идёт без обращения к БД.
+class AuthorizationSnapshot {
+public:
+    static std::shared_ptr<const AuthorizationSnapshot> build(const dao::AuthorizationRows& rows);
+
+    PermissionSet permissions_of(const std::string& user_id) const;
+    bool has_permission(const std::string& user_id, models::AccessPermissionType permission) const;
+    bool has_permission(const std::string& user_id, const std::string& permission_name) const;
+    bool has_role(const std::string& user_id, const std::string& role_name) const;
+    std::vector<std::string> permission_names(const std::string& user_id) const;
+    // Идентификаторы пользователей с ролью; перебор всех пользователей снимка
+    std::vector<std::string> members_of(const std::string& role_name) const;
+
+    size_t role_count() const { return roles_.size(); }
+    size_t user_count() const { return user_roles_.size(); }
+    std::chrono::steady_clock::time_point built_at() const { return built_at_; }
+
+private:
+    struct Role {
+        std::string name;
+        PermissionSet permissions;
+        // Разрешения из БД, которых нет в AccessPermissionType
+        std::vector<std::string> other_permissions;
+    };
+
+    const std::vector<uint32_t>* roles_of(const std::string& user_id) const;
+
+    std::vector<Role> roles_;
+    std::unordered_map<std::string, std::vector<uint32_t>> user_roles_;
+    std::chrono::steady_clock::time_point built_at_ = std::chrono::steady_clock::now();
+};
+
+} // namespace services
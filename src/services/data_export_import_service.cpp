@@ -51,27 +51,40 @@ bool DataExportImportService::export_data(
 
 bool DataExportImportService::import_data(
     const std::string &file_path,
-    const std::shared_ptr<const models::User> &actor) {
+    const std::shared_ptr<const models::User> &actor, bool merge) {
     try {
         io_handler_->println("Importing data from: " + file_path);
         log_service_->info(models::ActionType::SYSTEM_IMPORT,
                            "Starting data import from: " + file_path, actor,
                            nullptr);
 
-        bool result = export_import_dao_->import_from_file(file_path);
-        if (result) {
+        dao::ImportOptions options;
+        options.merge = merge;
+        auto result = export_import_dao_->import_from_file(file_path, options);
+        if (result.success) {
+            std::string summary =
+                "users: " + std::to_string(result.users_read) + " read, " +
+                std::to_string(result.users_inserted) + " inserted, " +
+                std::to_string(result.users_updated) + " updated; roles: " +
+                std::to_string(result.roles_read) + " read, " +
+                std::to_string(result.roles_inserted) + " inserted, " +
+                std::to_string(result.roles_updated) + " updated; assignments: " +
+                std::to_string(result.assignments_read) + " read, " +
+                std::to_string(result.assignments_inserted) + " inserted";
             io_handler_->println("✅ Data imported successfully");
+            io_handler_->println("   " + summary);
             log_service_->info(models::ActionType::SYSTEM_IMPORT,
                                "Data import completed successfully: " +
-                                   file_path,
+                                   file_path + " (" + summary + ")",
                                actor, nullptr);
         } else {
-            io_handler_->error("❌ Data import failed");
+            io_handler_->error("❌ Data import failed: " + result.error);
             log_service_->error(models::ActionType::SYSTEM_IMPORT,
-                                "Data import failed: " + file_path, actor,
-                                nullptr);
+                                "Data import failed: " + file_path + ": " +
+                                    result.error,
+                                actor, nullptr);
         }
-        return result;
+        return result.success;
     } catch (const std::exception &e) {
         io_handler_->error("❌ Import error: " + std::string(e.what()));
         log_service_->error(models::ActionType::SYSTEM_IMPORT,
@@ -90,6 +103,7 @@ bool DataExportImportService::create_backup(
                            "Starting backup creation: " + backup_path, actor,
                            nullptr);
 
+        log_service_->flush();
         bool result = export_import_dao_->create_backup(backup_path);
         if (result) {
             io_handler_->println("✅ Backup created successfully");
@@ -153,6 +167,7 @@ bool DataExportImportService::export_logs_csv(
                            "Starting logs export to CSV: " + file_path, actor,
                            nullptr);
 
+        log_service_->flush();
         bool result = export_import_dao_->export_logs_to_csv(file_path);
         if (result) {
             io_handler_->println("✅ Logs exported successfully");
@@ -18,7 +18,8 @@ public:
         std::shared_ptr<LogService> log_service);
 
     bool export_data(const std::string& file_path, const std::shared_ptr<const models::User>& actor = nullptr);
-    bool import_data(const std::string& file_path, const std::shared_ptr<const models::User>& actor = nullptr);
+    bool import_data(const std::string& file_path, const std::shared_ptr<const models::User>& actor = nullptr,
+                     bool merge = false);
     bool create_backup(const std::string& backup_path, const std::shared_ptr<const models::User>& actor = nullptr);
     bool restore_backup(const std::string& backup_path, const std::shared_ptr<const models::User>& actor = nullptr);
     bool export_logs_csv(const std::string& file_path, const std::shared_ptr<const models::User>& actor = nullptr);
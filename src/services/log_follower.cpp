@@ -0,0 +1,50 @@
+#include "log_follower.hpp"
+
+namespace services {
+
+LogFollower::Receiver::Receiver(pqxx::connection& conn, std::vector<std::string>& pending)
+    : pqxx::notification_receiver(conn, dao::LOG_NOTIFY_CHANNEL), pending_(pending) {}
+
+void LogFollower::Receiver::operator()(const std::string& payload, int) {
+    size_t start = 0;
+    while (start < payload.size()) {
+        size_t comma = payload.find(',', start);
+        if (comma == std::string::npos) {
+            comma = payload.size();
+        }
+        if (comma > start) {
+            pending_.push_back(payload.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+}
+
+LogFollower::LogFollower(std::shared_ptr<dao::LogDAO> log_dao, dao::LogFilter filter)
+    : log_dao_(std::move(log_dao)),
+      filter_(std::move(filter)),
+      connection_(log_dao_->open_listener_connection()),
+      receiver_(std::make_unique<Receiver>(*connection_, pending_)) {}
+
+// Подписка снимается раньше, чем закрывается соединение
+LogFollower::~LogFollower() {
+    receiver_.reset();
+}
+
+models::SystemLogBatch LogFollower::poll(std::chrono::milliseconds timeout) {
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(timeout - seconds);
+    if (connection_->await_notification(static_cast<long>(seconds.count()),
+                                        static_cast<long>(microseconds.count())) > 0) {
+        // Уведомления, пришедшие вместе с первым, обрабатываются без ожидания
+        connection_->get_notifs();
+    }
+
+    if (pending_.empty()) {
+        return {};
+    }
+    std::vector<std::string> ids;
+    ids.swap(pending_);
+    return log_dao_->find_by_ids_batch(ids, filter_);
+}
+
+} // namespace services
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "src/dao/log_dao.hpp"
+#include "src/models/system_log_batch.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+
+namespace services {
+
+// Подписка на новые записи журнала. Держит своё соединение с LISTEN на
+// dao::LOG_NOTIFY_CHANNEL и по пришедшим id дочитывает только новые строки,
+// подходящие под фильтр, - без повторных запросов всей страницы и COUNT.
+class LogFollower {
+public:
+    LogFollower(std::shared_ptr<dao::LogDAO> log_dao, dao::LogFilter filter);
+    ~LogFollower();
+
+    LogFollower(const LogFollower&) = delete;
+    LogFollower& operator=(const LogFollower&) = delete;
+
+    // Ждёт уведомлений не дольше timeout. Пустой пакет - новых подходящих записей нет.
+    models::SystemLogBatch poll(std::chrono::milliseconds timeout);
+
+private:
+    class Receiver : public pqxx::notification_receiver {
+    public:
+        Receiver(pqxx::connection& conn, std::vector<std::string>& pending);
+        void operator()(const std::string& payload, int backend_pid) override;
+
+    private:
+        std::vector<std::string>& pending_;
+    };
+
+    std::shared_ptr<dao::LogDAO> log_dao_;
+    dao::LogFilter filter_;
+    std::unique_ptr<pqxx::connection> connection_;
+    std::vector<std::string> pending_;
+    std::unique_ptr<Receiver> receiver_;
+};
+
+} // namespace services
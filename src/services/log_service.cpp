@@ -5,12 +5,14 @@
 #include <chrono>
 #include <ctime>
 #include <iomanip>
+#include <iostream>
 #include <sstream>
 
 namespace services
 {
-LogService::LogService(std::shared_ptr<dao::LogDAO> log_dao)
-    : log_dao_(std::move(log_dao)) {}
+LogService::LogService(std::shared_ptr<dao::LogDAO> log_dao,
+                       std::shared_ptr<AsyncLogWriter> writer)
+    : log_dao_(std::move(log_dao)), writer_(std::move(writer)) {}
 
 void LogService::log(models::LogLevel level, models::ActionType action_type,
                      const std::string &message,
@@ -20,7 +22,23 @@ void LogService::log(models::LogLevel level, models::ActionType action_type,
                      const std::string &user_agent) {
     auto entry = create_log_entry(level, action_type, message, actor, subject,
                                   ip_address, user_agent);
-    log_dao_->save(entry);
+    if (writer_) {
+        writer_->enqueue(std::move(entry));
+    } else {
+        log_dao_->save(entry);
+    }
+}
+
+void LogService::flush() {
+    if (writer_) {
+        writer_->flush();
+    }
+}
+
+void LogService::shutdown() {
+    if (writer_) {
+        writer_->shutdown();
+    }
 }
 
 std::shared_ptr<models::SystemLog> LogService::create_log_entry(
@@ -134,32 +152,75 @@ std::vector<std::shared_ptr<models::SystemLog>> LogService::get_logs(
     if (end_time.has_value())
         filter.end_time = *end_time;
 
-    dao::LogQueryResult dao_result = log_dao_->find_by_filter(filter, pagination);
-    return dao_result.logs;
+    return get_logs_page(filter, pagination).logs;
+}
+
+dao::LogQueryResult LogService::get_logs_page(const dao::LogFilter &filter,
+                                              const dao::Pagination &pagination) {
+    flush();
+    return log_dao_->find_by_filter(filter, pagination);
+}
+
+dao::LogBatchQueryResult LogService::get_logs_page_batch(const dao::LogFilter &filter,
+                                                         const dao::Pagination &pagination) {
+    flush();
+    return log_dao_->find_by_filter_batch(filter, pagination);
+}
+
+bool LogService::for_each_log(const dao::LogFilter &filter,
+                              const std::function<bool(const models::SystemLogView &)> &callback,
+                              size_t batch_size) {
+    flush();
+    return log_dao_->for_each_log(filter, callback, batch_size);
+}
+
+std::vector<dao::LogSearchHit> LogService::search_logs(const std::string &query,
+                                                      const dao::LogFilter &filter,
+                                                      size_t limit) {
+    flush();
+    return log_dao_->search_messages(query, filter, limit);
+}
+
+std::vector<dao::IndexUsage> LogService::check_index_usage() {
+    return log_dao_->check_index_usage();
+}
+
+std::unique_ptr<LogFollower> LogService::follow(const dao::LogFilter &filter) {
+    try {
+        return std::make_unique<LogFollower>(log_dao_, filter);
+    } catch (const std::exception &e) {
+        std::cerr << "Error in LogService::follow: " << e.what() << std::endl;
+        return nullptr;
+    }
 }
 
 std::vector<std::shared_ptr<models::SystemLog>>
 LogService::get_recent_logs(size_t limit) {
+    flush();
     return log_dao_->find_recent_logs(limit);
 }
 
 std::vector<std::shared_ptr<models::SystemLog>>
 LogService::get_logs_by_level(models::LogLevel level, size_t limit) {
+    flush();
     return log_dao_->find_by_level(level, limit);
 }
 
 std::vector<std::shared_ptr<models::SystemLog>>
 LogService::get_logs_by_action(models::ActionType action_type, size_t limit) {
+    flush();
     return log_dao_->find_by_action_type(action_type, limit);
 }
 
 std::vector<std::shared_ptr<models::SystemLog>>
 LogService::get_logs_by_actor_id(const std::string &actor_id, size_t limit) {
+    flush();
     return log_dao_->find_by_actor(actor_id, limit);
 }
 
 std::vector<std::shared_ptr<models::SystemLog>>
 LogService::get_logs_by_subject_id(const std::string &subject_id, size_t limit) {
+    flush();
     return log_dao_->find_by_subject(subject_id, limit);
 }
 
@@ -181,13 +242,19 @@ bool LogService::cleanup_old_logs(int days_to_keep) {
     try {
         auto now = std::chrono::system_clock::now();
         auto cutoff_time = now - std::chrono::hours(24 * days_to_keep);
+        flush();
 
-        return log_dao_->cleanup_old_logs(cutoff_time);
+        bool cleaned = log_dao_->cleanup_old_logs(cutoff_time);
+        return log_dao_->compact_rollups() && cleaned;
     } catch (const std::exception& e) {
         return false;
     }
 }
 
+bool LogService::fold_rollups() {
+    return log_dao_->fold_rollups();
+}
+
 bool LogService::delete_logs(
     const std::vector<std::shared_ptr<models::SystemLog>> &logs) {
     bool all_deleted = true;
@@ -199,7 +266,23 @@ bool LogService::delete_logs(
     return all_deleted;
 }
 
-size_t LogService::get_total_log_count() { return log_dao_->get_log_count(); }
+size_t LogService::get_total_log_count() {
+    flush();
+    return log_dao_->get_log_count();
+}
+
+std::vector<std::pair<models::LogLevel, size_t>> LogService::get_level_distribution() {
+    flush();
+    return log_dao_->get_log_level_distribution();
+}
+
+std::vector<std::pair<std::string, size_t>>
+LogService::get_log_histogram(const std::chrono::system_clock::time_point &start,
+                              const std::chrono::system_clock::time_point &end,
+                              const std::string &granularity) {
+    flush();
+    return log_dao_->get_log_histogram(start, end, granularity);
+}
 
 std::chrono::system_clock::time_point
 LogService::sql_string_to_time_point(const std::string &sql_time) const {
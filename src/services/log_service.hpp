@@ -1,11 +1,14 @@
 #pragma once
 
 #include "src/dao/log_dao.hpp"
+#include "src/services/async_log_writer.hpp"
+#include "src/services/log_follower.hpp"
 #include "src/dao/user_dao.hpp"
 #include "src/models/enums.hpp"
 #include "src/models/system_log.hpp"
 #include "src/models/user.hpp"
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,7 +17,9 @@
 namespace services {
 class LogService {
 public:
-    explicit LogService(std::shared_ptr<dao::LogDAO> log_dao);
+    // Без writer записи сохраняются синхронно, по одной на транзакцию
+    explicit LogService(std::shared_ptr<dao::LogDAO> log_dao,
+                        std::shared_ptr<AsyncLogWriter> writer = nullptr);
 
     void log(models::LogLevel level, models::ActionType action_type,
              const std::string &message,
@@ -58,6 +63,30 @@ public:
         std::optional<std::chrono::system_clock::time_point> end_time = std::nullopt,
         size_t limit = 100);
 
+    // Страница журнала: продолжение по next_cursor, общее число по pagination.count_mode
+    dao::LogQueryResult get_logs_page(const dao::LogFilter &filter,
+                                      const dao::Pagination &pagination);
+    // То же без shared_ptr на запись, для просмотра и выгрузки больших страниц
+    dao::LogBatchQueryResult get_logs_page_batch(const dao::LogFilter &filter,
+                                                 const dao::Pagination &pagination);
+
+    // Все записи под фильтром от старых к новым без загрузки результата целиком;
+    // false из callback останавливает обход. Возвращает false при ошибке БД
+    bool for_each_log(const dao::LogFilter &filter,
+                      const std::function<bool(const models::SystemLogView &)> &callback,
+                      size_t batch_size = 1000);
+
+    // Полнотекстовый поиск по сообщениям, самые релевантные первыми
+    std::vector<dao::LogSearchHit> search_logs(const std::string &query,
+                                               const dao::LogFilter &filter = {},
+                                               size_t limit = 50);
+
+    // Какие запросы журнала читают индекс (см. dao::IndexUsage)
+    std::vector<dao::IndexUsage> check_index_usage();
+
+    // Подписка на новые записи под фильтром; nullptr, если не удалось открыть соединение
+    std::unique_ptr<LogFollower> follow(const dao::LogFilter &filter);
+
     // Logs Receive
     std::vector<std::shared_ptr<models::SystemLog>>
     get_recent_logs(size_t limit = 100);
@@ -79,17 +108,31 @@ public:
                            const std::string &end_date, size_t limit);
 
     bool cleanup_old_logs(int days_to_keep = 30);
+    // Переносит поправки счётчиков в system_log_rollup; без AsyncLogWriter вызывается явно
+    bool fold_rollups();
     bool
     delete_logs(const std::vector<std::shared_ptr<models::SystemLog>> &logs);
 
     size_t get_total_log_count();
 
+    // Статистика по почасовым счётчикам журнала, без сканирования system_log
+    std::vector<std::pair<models::LogLevel, size_t>> get_level_distribution();
+    std::vector<std::pair<std::string, size_t>>
+    get_log_histogram(const std::chrono::system_clock::time_point &start,
+                      const std::chrono::system_clock::time_point &end,
+                      const std::string &granularity = "hour");
+
+    // Дожидается записи в БД всех событий, поставленных в очередь ранее
+    void flush();
+    void shutdown();
+
     std::chrono::system_clock::time_point sql_string_to_time_point(const std::string &sql_time) const;
 
     std::optional<std::chrono::system_clock::time_point> parse_time(const std::string &sql_time) const;
 
 private:
     std::shared_ptr<dao::LogDAO> log_dao_;
+    std::shared_ptr<AsyncLogWriter> writer_;
 
     std::shared_ptr<models::SystemLog>
     create_log_entry(models::LogLevel level, models::ActionType action_type,
@@ -0,0 +1,221 @@
+#include "login_rate_limiter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <mutex>
+
+namespace services {
+
+namespace {
+// Младшие 24 бита слова корзины - счётчик, старшие 40 - номер такта
+constexpr int COUNT_BITS = 24;
+constexpr uint64_t COUNT_MASK = (uint64_t{1} << COUNT_BITS) - 1;
+
+int64_t tick_of(uint64_t slot) { return static_cast<int64_t>(slot >> COUNT_BITS); }
+uint32_t count_of(uint64_t slot) { return static_cast<uint32_t>(slot & COUNT_MASK); }
+
+// Регистр почты не должен давать обойти лимит
+std::string email_key(const std::string& email) {
+    std::string key = email;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+} // namespace
+
+LoginRateLimiter::Window::Window(size_t buckets)
+    : slots_(new std::atomic<uint64_t>[buckets]), size_(buckets) {
+    reset();
+}
+
+void LoginRateLimiter::Window::add(int64_t tick) {
+    auto& slot = slots_[static_cast<size_t>(tick) % size_];
+    uint64_t current = slot.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        if (tick_of(current) != tick) {
+            // Корзина осталась от прошлого круга - начинаем её заново
+            next = (static_cast<uint64_t>(tick) << COUNT_BITS) | 1;
+        } else if (count_of(current) == COUNT_MASK) {
+            return;
+        } else {
+            next = current + 1;
+        }
+    } while (!slot.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+uint32_t LoginRateLimiter::Window::total(int64_t tick) const {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < size_; ++i) {
+        uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+        int64_t slot_tick = tick_of(slot);
+        if (slot_tick <= tick && slot_tick > tick - static_cast<int64_t>(size_)) {
+            sum += count_of(slot);
+        }
+    }
+    return sum;
+}
+
+int64_t LoginRateLimiter::Window::last_tick() const {
+    int64_t last = 0;
+    for (size_t i = 0; i < size_; ++i) {
+        if (count_of(slots_[i].load(std::memory_order_relaxed)) > 0) {
+            last = std::max(last, tick_of(slots_[i].load(std::memory_order_relaxed)));
+        }
+    }
+    return last;
+}
+
+void LoginRateLimiter::Window::reset() {
+    for (size_t i = 0; i < size_; ++i) {
+        slots_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+LoginRateLimiter::CounterTable::CounterTable(size_t shards, size_t buckets)
+    : shards_(std::max<size_t>(shards, 1)), buckets_(buckets) {}
+
+LoginRateLimiter::CounterTable::Shard& LoginRateLimiter::CounterTable::shard_for(const std::string& key) {
+    return shards_[std::hash<std::string>{}(key) % shards_.size()];
+}
+
+const LoginRateLimiter::CounterTable::Shard& LoginRateLimiter::CounterTable::shard_for(const std::string& key) const {
+    return shards_[std::hash<std::string>{}(key) % shards_.size()];
+}
+
+void LoginRateLimiter::CounterTable::add(const std::string& key, int64_t tick) {
+    auto& shard = shard_for(key);
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.windows.find(key);
+        if (it != shard.windows.end()) {
+            it->second->add(tick);
+            return;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    sweep(shard, tick);
+    auto& window = shard.windows[key];
+    if (!window) {
+        window = std::make_unique<Window>(buckets_);
+    }
+    window->add(tick);
+}
+
+// Не чаще раза за окно удаляет ключи, у которых все корзины устарели
+void LoginRateLimiter::CounterTable::sweep(Shard& shard, int64_t tick) {
+    int64_t horizon = tick - static_cast<int64_t>(buckets_);
+    if (shard.swept_tick > horizon) {
+        return;
+    }
+    for (auto it = shard.windows.begin(); it != shard.windows.end();) {
+        if (it->second->last_tick() <= horizon) {
+            it = shard.windows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    shard.swept_tick = tick;
+}
+
+uint32_t LoginRateLimiter::CounterTable::total(const std::string& key, int64_t tick) const {
+    const auto& shard = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.windows.find(key);
+    return it == shard.windows.end() ? 0 : it->second->total(tick);
+}
+
+void LoginRateLimiter::CounterTable::reset(const std::string& key) {
+    auto& shard = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.windows.find(key);
+    if (it != shard.windows.end()) {
+        it->second->reset();
+    }
+}
+
+size_t LoginRateLimiter::CounterTable::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.windows.size();
+    }
+    return total;
+}
+
+std::vector<std::pair<std::string, uint32_t>> LoginRateLimiter::CounterTable::snapshot(int64_t tick) const {
+    std::vector<std::pair<std::string, uint32_t>> result;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& [key, window] : shard.windows) {
+            if (uint32_t count = window->total(tick)) {
+                result.emplace_back(key, count);
+            }
+        }
+    }
+    return result;
+}
+
+LoginRateLimiter::LoginRateLimiter(LoginRateLimiterConfig config)
+    : config_(std::move(config)),
+      bucket_width_(std::max<std::chrono::steady_clock::duration>(
+          config_.window / static_cast<int64_t>(std::max<size_t>(config_.buckets, 1)),
+          std::chrono::milliseconds(1))),
+      email_failures_(config_.shards, std::max<size_t>(config_.buckets, 1)),
+      source_attempts_(config_.shards, std::max<size_t>(config_.buckets, 1)) {}
+
+int64_t LoginRateLimiter::current_tick() const {
+    return std::chrono::steady_clock::now().time_since_epoch() / bucket_width_;
+}
+
+ThrottleDecision LoginRateLimiter::check(const std::string& email, const std::string& source) {
+    int64_t tick = current_tick();
+
+    // Попытка источника учитывается и тогда, когда её отклонят:
+    // продолжающий перебор источник остаётся заблокированным
+    source_attempts_.add(source, tick);
+    if (source_attempts_.total(source, tick) > config_.max_attempts_per_source) {
+        rejected_source_.fetch_add(1, std::memory_order_relaxed);
+        return ThrottleDecision::SOURCE_BLOCKED;
+    }
+
+    if (email_failures_.total(email_key(email), tick) >= config_.max_failures_per_email) {
+        rejected_email_.fetch_add(1, std::memory_order_relaxed);
+        return ThrottleDecision::EMAIL_BLOCKED;
+    }
+    return ThrottleDecision::ALLOWED;
+}
+
+void LoginRateLimiter::record_failure(const std::string& email) {
+    email_failures_.add(email_key(email), current_tick());
+}
+
+void LoginRateLimiter::record_success(const std::string& email) {
+    email_failures_.reset(email_key(email));
+}
+
+LoginRateLimiterStats LoginRateLimiter::stats() const {
+    LoginRateLimiterStats stats;
+    stats.tracked_emails = email_failures_.size();
+    stats.tracked_sources = source_attempts_.size();
+    stats.rejected_email = rejected_email_.load(std::memory_order_relaxed);
+    stats.rejected_source = rejected_source_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::vector<ThrottleEntry> LoginRateLimiter::entries() const {
+    int64_t tick = current_tick();
+    std::vector<ThrottleEntry> result;
+    for (auto& [key, count] : email_failures_.snapshot(tick)) {
+        result.push_back({ThrottleScope::EMAIL, key, count, count >= config_.max_failures_per_email});
+    }
+    for (auto& [key, count] : source_attempts_.snapshot(tick)) {
+        result.push_back({ThrottleScope::SOURCE, key, count, count > config_.max_attempts_per_source});
+    }
+    std::sort(result.begin(), result.end(),
+              [](const ThrottleEntry& a, const ThrottleEntry& b) { return a.count > b.count; });
+    return result;
+}
+
+} // namespace services
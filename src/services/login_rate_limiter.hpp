@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace services {
+
+struct LoginRateLimiterConfig {
+    // Скользящее окно делится на buckets корзин; старые корзины выпадают сами
+    std::chrono::seconds window{300};
+    size_t buckets = 10;
+    // Неудачных входов на почту и попыток с одного источника за окно
+    uint32_t max_failures_per_email = 5;
+    uint32_t max_attempts_per_source = 50;
+    size_t shards = 16;
+};
+
+enum class ThrottleDecision {
+    ALLOWED,
+    EMAIL_BLOCKED,
+    SOURCE_BLOCKED
+};
+
+enum class ThrottleScope { EMAIL, SOURCE };
+
+struct ThrottleEntry {
+    ThrottleScope scope;
+    std::string key;
+    uint32_t count = 0;
+    bool blocked = false;
+};
+
+struct LoginRateLimiterStats {
+    size_t tracked_emails = 0;
+    size_t tracked_sources = 0;
+    uint64_t rejected_email = 0;
+    uint64_t rejected_source = 0;
+};
+
+// Ограничитель перебора паролей в памяти. Проверка выполняется до чтения
+// пользователя из БД и до PBKDF2, поэтому отклонённая попытка почти бесплатна.
+class LoginRateLimiter {
+public:
+    explicit LoginRateLimiter(LoginRateLimiterConfig config = {});
+
+    // Учитывает попытку источника и решает, допускать ли её
+    ThrottleDecision check(const std::string& email, const std::string& source);
+    void record_failure(const std::string& email);
+    // Успешный вход сбрасывает счётчик неудач почты
+    void record_success(const std::string& email);
+
+    LoginRateLimiterStats stats() const;
+    // Ключи с ненулевым счётчиком в текущем окне, для просмотра администратором
+    std::vector<ThrottleEntry> entries() const;
+    const LoginRateLimiterConfig& config() const { return config_; }
+
+private:
+    // Счётчики одного ключа: в каждой корзине номер такта и число событий
+    // упакованы в одно 64-битное слово и обновляются CAS без блокировок
+    class Window {
+    public:
+        explicit Window(size_t buckets);
+        void add(int64_t tick);
+        uint32_t total(int64_t tick) const;
+        int64_t last_tick() const;
+        void reset();
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+        size_t size_;
+    };
+
+    // Сегментированная таблица окон. Счётчики меняются под разделяемой
+    // блокировкой сегмента; исключительная нужна только для вставки и вытеснения.
+    class CounterTable {
+    public:
+        CounterTable(size_t shards, size_t buckets);
+        void add(const std::string& key, int64_t tick);
+        uint32_t total(const std::string& key, int64_t tick) const;
+        void reset(const std::string& key);
+        size_t size() const;
+        std::vector<std::pair<std::string, uint32_t>> snapshot(int64_t tick) const;
+
+    private:
+        struct Shard {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<std::string, std::unique_ptr<Window>> windows;
+            int64_t swept_tick = 0;
+        };
+
+        Shard& shard_for(const std::string& key);
+        const Shard& shard_for(const std::string& key) const;
+        void sweep(Shard& shard, int64_t tick);
+
+        std::vector<Shard> shards_;
+        size_t buckets_;
+    };
+
+    int64_t current_tick() const;
+
+    LoginRateLimiterConfig config_;
+    std::chrono::steady_clock::duration bucket_width_;
+    CounterTable email_failures_;
+    CounterTable source_attempts_;
+    std::atomic<uint64_t> rejected_email_{0};
+    std::atomic<uint64_t> rejected_source_{0};
+};
+
+} // namespace services
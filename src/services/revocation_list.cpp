@@ -0,0 +1,163 @@
+#include "revocation_list.hpp"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+namespace services {
+
+namespace {
+// Шаг ожидания уведомлений: за это время stop_watching дождётся потока
+constexpr std::chrono::milliseconds WATCH_TICK{200};
+} // namespace
+
+RevocationList::Receiver::Receiver(pqxx::connection& conn, bool& notified)
+    : pqxx::notification_receiver(conn, dao::REVOCATION_NOTIFY_CHANNEL), notified_(notified) {}
+
+void RevocationList::Receiver::operator()(const std::string&, int) {
+    notified_ = true;
+}
+
+RevocationList::RevocationList(std::shared_ptr<dao::RevocationDAO> revocation_dao, size_t expected_subjects)
+    : revocation_dao_(std::move(revocation_dao)), filter_(expected_subjects) {}
+
+RevocationList::~RevocationList() {
+    stop_watching();
+}
+
+void RevocationList::start_watching(std::chrono::milliseconds interval) {
+    if (watching_.exchange(true)) {
+        return;
+    }
+    watcher_ = std::thread(&RevocationList::watch, this, interval);
+}
+
+void RevocationList::stop_watching() {
+    watching_ = false;
+    if (watcher_.joinable()) {
+        watcher_.join();
+    }
+}
+
+void RevocationList::watch(std::chrono::milliseconds interval) {
+    std::unique_ptr<pqxx::connection> connection;
+    std::unique_ptr<Receiver> receiver;
+    bool notified = false;
+    auto now = std::chrono::steady_clock::now();
+    auto next_refresh = now + interval;
+    auto next_connect = now;
+
+    while (watching_) {
+        now = std::chrono::steady_clock::now();
+        if (!connection && now >= next_connect) {
+            try {
+                connection = revocation_dao_->open_listener_connection();
+                receiver = std::make_unique<Receiver>(*connection, notified);
+                // Отзывы, зафиксированные до LISTEN, дочитываются сразу
+                notified = true;
+            } catch (const std::exception &e) {
+                std::cerr << "Error in RevocationList::watch: " << e.what() << std::endl;
+                receiver.reset();
+                connection.reset();
+                next_connect = now + interval;
+            }
+        }
+
+        if (connection) {
+            try {
+                connection->await_notification(0, static_cast<long>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(WATCH_TICK).count()));
+            } catch (const std::exception &e) {
+                // Соединение потеряно: до переподключения работает опрос по interval
+                std::cerr << "Error in RevocationList::watch: " << e.what() << std::endl;
+                receiver.reset();
+                connection.reset();
+                next_connect = now + interval;
+            }
+        } else {
+            std::this_thread::sleep_for(WATCH_TICK);
+        }
+
+        now = std::chrono::steady_clock::now();
+        if (notified || now >= next_refresh) {
+            notified = false;
+            refresh();
+            next_refresh = now + interval;
+        }
+    }
+
+    // Подписка снимается раньше, чем закрывается соединение
+    receiver.reset();
+}
+
+bool RevocationList::revoke(const std::string &subject_id, const std::string &reason) {
+    auto entry = revocation_dao_->revoke(subject_id, reason);
+    if (!entry) {
+        return false;
+    }
+    // last_seq_ не сдвигается: между ним и seq этой записи могут быть
+    // ещё не прочитанные отзывы других процессов
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        apply(*entry);
+    }
+    // Заодно подтягиваем отзывы других процессов, случившиеся с прошлой загрузки
+    refresh();
+    return true;
+}
+
+bool RevocationList::refresh() {
+    int64_t after_seq;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        after_seq = last_seq_;
+    }
+
+    auto entries = revocation_dao_->load_since(after_seq);
+    if (!entries) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (const auto &entry : *entries) {
+        apply(entry);
+        last_seq_ = std::max(last_seq_, entry.seq);
+    }
+    return true;
+}
+
+void RevocationList::apply(const dao::RevocationEntry &entry) {
+    auto &revoked_at = revoked_at_[entry.subject_id];
+    revoked_at = std::max(revoked_at, entry.revoked_at);
+
+    if (revoked_at_.size() > filter_.capacity()) {
+        // Фильтр переполнен: перестраиваем вдвое большим из точной таблицы
+        utils::BlockedBloomFilter grown(filter_.capacity() * 2);
+        for (const auto &[subject_id, _] : revoked_at_) {
+            grown.insert(subject_id);
+        }
+        filter_ = std::move(grown);
+    } else {
+        filter_.insert(entry.subject_id);
+    }
+}
+
+bool RevocationList::is_revoked(const std::string &subject_id,
+                                std::chrono::system_clock::time_point issued_at) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!filter_.may_contain(subject_id)) {
+        return false;
+    }
+    auto it = revoked_at_.find(subject_id);
+    if (it == revoked_at_.end()) {
+        return false;
+    }
+    auto issued = std::chrono::duration_cast<std::chrono::seconds>(issued_at.time_since_epoch()).count();
+    return issued <= it->second;
+}
+
+size_t RevocationList::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return revoked_at_.size();
+}
+
+} // namespace services
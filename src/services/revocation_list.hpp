@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <pqxx/pqxx>
+#include "src/dao/revocation_dao.hpp"
+#include "src/utils/blocked_bloom_filter.hpp"
+
+namespace services {
+
+// Отозванные субъекты (пользователи) в памяти. Частый ответ "не отозван"
+// даёт блочный фильтр Блума за одну кэш-линию; точная таблица проверяется
+// только при срабатывании фильтра. Состояние хранится в revoked_subject и
+// дочитывается по seq, без пересканирования app_user. Отзывы других процессов
+// подтягивает фоновый поток (start_watching) по NOTIFY.
+class RevocationList {
+public:
+    explicit RevocationList(std::shared_ptr<dao::RevocationDAO> revocation_dao,
+                            size_t expected_subjects = 1024);
+    ~RevocationList();
+
+    RevocationList(const RevocationList&) = delete;
+    RevocationList& operator=(const RevocationList&) = delete;
+
+    // Отзывает все выданные до этого момента токены субъекта
+    bool revoke(const std::string& subject_id, const std::string& reason);
+    // Дочитывает записи, появившиеся после последней загрузки (в т.ч. из других процессов)
+    bool refresh();
+
+    // Фоновый поток: refresh() сразу по уведомлению об отзыве, а если уведомлений
+    // нет или соединение потеряно - не реже раза в interval
+    void start_watching(std::chrono::milliseconds interval = std::chrono::seconds(5));
+    void stop_watching();
+
+    // Токен, выданный в issued_at, отозван, если субъект отозван не раньше этого момента
+    bool is_revoked(const std::string& subject_id,
+                    std::chrono::system_clock::time_point issued_at) const;
+
+    size_t size() const;
+
+private:
+    class Receiver : public pqxx::notification_receiver {
+    public:
+        Receiver(pqxx::connection& conn, bool& notified);
+        void operator()(const std::string& payload, int backend_pid) override;
+
+    private:
+        bool& notified_;
+    };
+
+    void apply(const dao::RevocationEntry& entry);
+    void watch(std::chrono::milliseconds interval);
+
+    std::shared_ptr<dao::RevocationDAO> revocation_dao_;
+    mutable std::shared_mutex mutex_;
+    utils::BlockedBloomFilter filter_;
+    std::unordered_map<std::string, int64_t> revoked_at_;
+    int64_t last_seq_ = 0;
+
+    std::thread watcher_;
+    std::atomic<bool> watching_{false};
+};
+
+} // namespace services
@@ -7,27 +7,46 @@
 #include "src/utils/password_utils.hpp"
 #include "log_service.hpp"
 #include "src/models/enums.hpp"
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace services {
 
+namespace {
+std::string lowercase(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+} // namespace
+
 UserService::UserService(
     std::shared_ptr<IOHandler> io_handler, std::shared_ptr<dao::UserDAO> user_dao,
     std::shared_ptr<dao::AccessPermissionDAO> permission_dao,
-    std::shared_ptr<LogService> log_service)
+    std::shared_ptr<LogService> log_service,
+    std::shared_ptr<RevocationList> revocations,
+    std::shared_ptr<utils::HashingWorkerPool> hashing_pool)
     : io_handler_(std::move(io_handler)), user_dao_(std::move(user_dao)),
-      permission_dao_(std::move(permission_dao)), log_service_(std::move(log_service)) {}
+      permission_dao_(std::move(permission_dao)), log_service_(std::move(log_service)),
+      revocations_(std::move(revocations)), hashing_pool_(std::move(hashing_pool)) {}
 
 void UserService::initialize_system() {
     try {
         io_handler_->println("Initializing system...");
         log_service_->info(models::ActionType::SYSTEM_STARTUP, "Starting system initialization");
 
-        permission_dao_->initialize_system_permissions();
-
+        // Системные разрешения и роли создаются миграциями схемы
         create_system_roles();
 
-        if (create_default_admin()) {
+        bool admin_ready = create_default_admin();
+        refresh_authorization();
+
+        if (admin_ready) {
             io_handler_->println("System initialization completed successfully");
             log_service_->info(models::ActionType::SYSTEM_STARTUP, "System initialization completed successfully");
         } else {
@@ -157,6 +176,7 @@ CreateUserResult UserService::create_user(const std::string &first_name,
                                      "Failed to assign role " + role_name + " to user: " + email,
                                      actor, new_user);
             } else {
+                authorization_changed();
                 log_service_->info(models::ActionType::USER_ROLE_CHANGED,
                                   "Assigned role " + role_name + " to user: " + email,
                                   actor, new_user);
@@ -183,6 +203,227 @@ CreateUserResult UserService::create_user(const std::string &first_name,
     }
 }
 
+std::vector<BulkUserResult>
+UserService::create_users_bulk(const std::vector<BulkUserRequest> &requests,
+                               const std::shared_ptr<const models::User> &actor) {
+    std::vector<BulkUserResult> results(requests.size());
+    std::vector<size_t> valid;
+    std::vector<std::vector<std::string>> role_ids;
+    std::vector<std::vector<std::string>> role_names;
+
+    // Проверки без обращения к БД, кроме одного чтения на каждое имя роли
+    std::unordered_map<std::string, std::shared_ptr<models::UserRole>> roles;
+    std::unordered_set<std::string> seen_emails;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto &request = requests[i];
+        auto &result = results[i];
+        result.email = request.email;
+
+        if (request.email.empty() || request.email.find('@') == std::string::npos) {
+            result.message = "Invalid email";
+            continue;
+        }
+        if (request.first_name.empty() || request.last_name.empty()) {
+            result.message = "First and last name are required";
+            continue;
+        }
+        if (!seen_emails.insert(lowercase(request.email)).second) {
+            result.message = "Duplicate email in request";
+            continue;
+        }
+
+        std::vector<std::string> ids;
+        std::vector<std::string> names = request.roles.empty() ? std::vector<std::string>{"USER"} : request.roles;
+        for (const auto &name : names) {
+            auto it = roles.find(name);
+            if (it == roles.end()) {
+                it = roles.emplace(name, get_role_by_name(name)).first;
+            }
+            if (!it->second) {
+                result.message = "Role not found: " + name;
+                break;
+            }
+            ids.push_back(it->second->id());
+        }
+        if (!result.message.empty()) {
+            continue;
+        }
+
+        valid.push_back(i);
+        role_ids.push_back(std::move(ids));
+        role_names.push_back(std::move(names));
+    }
+
+    // PBKDF2 - основная часть работы, поэтому хеши считает общий пул хеширования.
+    // В пуле одновременно не больше двух задач на поток, чтобы очередь оставалась
+    // свободной для входов; отклонённую пулом задачу считает вызывающий поток.
+    std::vector<std::string> passwords(valid.size());
+    std::vector<std::optional<std::string>> hashes(valid.size());
+    std::vector<std::string> errors(valid.size());
+    auto hash_here = [&](size_t k) {
+        try {
+            hashes[k] = utils::PasswordUtils::hash_password_pbkdf2(passwords[k]);
+        } catch (const std::exception &e) {
+            errors[k] = e.what();
+        }
+    };
+    for (size_t k = 0; k < valid.size(); ++k) {
+        passwords[k] = utils::PasswordUtils::generate_random_password(12);
+    }
+    if (!hashing_pool_) {
+        for (size_t k = 0; k < valid.size(); ++k) {
+            hash_here(k);
+        }
+    } else {
+        const size_t window = std::max<size_t>(hashing_pool_->stats().threads * 2, 1);
+        std::deque<std::pair<size_t, std::future<std::optional<std::string>>>> in_flight;
+        auto collect = [&]() {
+            auto [k, future] = std::move(in_flight.front());
+            in_flight.pop_front();
+            try {
+                hashes[k] = future.get();
+            } catch (const std::exception &e) {
+                errors[k] = e.what();
+                return;
+            }
+            if (!hashes[k]) {
+                hash_here(k);
+            }
+        };
+        for (size_t k = 0; k < valid.size(); ++k) {
+            if (in_flight.size() >= window) {
+                collect();
+            }
+            in_flight.emplace_back(k, hashing_pool_->hash_async(requests[valid[k]].email, passwords[k]));
+        }
+        while (!in_flight.empty()) {
+            collect();
+        }
+    }
+
+    std::vector<std::shared_ptr<models::User>> users(valid.size());
+    for (size_t k = 0; k < valid.size(); ++k) {
+        if (!hashes[k]) {
+            continue;
+        }
+        const auto &request = requests[valid[k]];
+        auto user = std::make_shared<models::User>(request.first_name, request.last_name, request.email);
+        user->set_password_hash(*hashes[k]);
+        user->require_password_change();
+        user->set_active(true);
+        results[valid[k]].generated_password = passwords[k];
+        users[k] = std::move(user);
+    }
+
+    std::vector<std::shared_ptr<models::User>> to_insert;
+    std::vector<std::vector<std::string>> to_insert_roles;
+    std::vector<std::vector<std::string>> to_insert_role_names;
+    std::vector<size_t> to_insert_index;
+    for (size_t k = 0; k < valid.size(); ++k) {
+        if (!users[k]) {
+            results[valid[k]].message = "Password hashing failed: " + errors[k];
+            continue;
+        }
+        to_insert.push_back(users[k]);
+        to_insert_roles.push_back(std::move(role_ids[k]));
+        to_insert_role_names.push_back(std::move(role_names[k]));
+        to_insert_index.push_back(valid[k]);
+    }
+
+    size_t created = 0;
+    if (!to_insert.empty()) {
+        auto inserted = user_dao_->save_bulk(to_insert, to_insert_roles);
+        for (size_t k = 0; k < to_insert.size(); ++k) {
+            auto &result = results[to_insert_index[k]];
+            if (!inserted) {
+                result.message = "Failed to save users to database";
+            } else if (!(*inserted)[k]) {
+                result.message = "User with this email already exists";
+            } else {
+                result.success = true;
+                result.message = "User created successfully";
+                ++created;
+                // Те же записи, что у create_user; LogService пишет их пакетами
+                const auto &user = to_insert[k];
+                for (const auto &role_name : to_insert_role_names[k]) {
+                    log_service_->info(models::ActionType::USER_ROLE_CHANGED,
+                                      "Assigned role " + role_name + " to user: " + user->email(),
+                                      actor, user);
+                }
+                log_service_->info(models::ActionType::USER_CREATED,
+                                  "User created in bulk: " + user->email(), actor, user);
+                continue;
+            }
+            result.generated_password.clear();
+        }
+    }
+
+    if (created > 0) {
+        authorization_changed();
+    }
+    log_service_->info(models::ActionType::USER_CREATED,
+                      "Bulk user creation: " + std::to_string(created) + " of " +
+                          std::to_string(requests.size()) + " users created",
+                      actor, nullptr);
+    return results;
+}
+
+std::shared_ptr<const AuthorizationSnapshot> UserService::authorization() const {
+    auto snapshot = std::atomic_load(&authorization_);
+    if (!snapshot) {
+        refresh_authorization();
+        return std::atomic_load(&authorization_);
+    }
+    if (std::chrono::steady_clock::now() - snapshot->built_at() >= AUTHORIZATION_TTL) {
+        // Устаревший снимок перечитывает один поток, остальные пока читают прежний
+        std::unique_lock<std::mutex> lock(authorization_rebuild_mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            rebuild_authorization();
+            snapshot = std::atomic_load(&authorization_);
+        }
+    }
+    return snapshot;
+}
+
+void UserService::refresh_authorization() const {
+    // Перестроения сериализуются, чтобы старый снимок не перезаписал более новый
+    std::lock_guard<std::mutex> lock(authorization_rebuild_mutex_);
+    rebuild_authorization();
+}
+
+void UserService::authorization_changed() {
+    if (authorization_deferred_) {
+        authorization_dirty_ = true;
+        return;
+    }
+    refresh_authorization();
+}
+
+void UserService::defer_authorization_refresh() {
+    authorization_deferred_ = true;
+}
+
+void UserService::resume_authorization_refresh() {
+    authorization_deferred_ = false;
+    if (authorization_dirty_.exchange(false)) {
+        refresh_authorization();
+    }
+}
+
+// Вызывается под authorization_rebuild_mutex_
+void UserService::rebuild_authorization() const {
+    auto rows = permission_dao_->load_authorization_rows();
+    if (!rows) {
+        // Оставляем предыдущий снимок; без снимка проверки прав отказывают
+        return;
+    }
+    std::atomic_store(&authorization_, AuthorizationSnapshot::build(*rows));
+}
+
+void UserService::invalidate_user_cache() {
+    user_dao_->clear_cache();
+}
+
 bool UserService::has_permission(
     const std::shared_ptr<const models::User> &user,
     const std::string &permission_name) const {
@@ -190,42 +431,85 @@ bool UserService::has_permission(
         return false;
     }
 
-    auto non_const_user = std::const_pointer_cast<models::User>(user);
-    auto roles = user_dao_->user_roles(non_const_user);
-
-    for (const auto &role : roles) {
-        if (permission_dao_->role_has_permission(role->id(), permission_name)) {
-            return true;
-        }
-    }
-
-    return false;
+    auto snapshot = authorization();
+    return snapshot && snapshot->has_permission(user->id(), permission_name);
 }
 
 std::vector<std::string> UserService::get_user_permissions(
     const std::shared_ptr<const models::User> &user) const {
-    std::vector<std::string> permissions;
-
     if (!user) {
-        return permissions;
+        return {};
     }
 
-    auto non_const_user = std::const_pointer_cast<models::User>(user);
-    auto roles = user_dao_->user_roles(non_const_user);
+    auto snapshot = authorization();
+    if (!snapshot) {
+        return {};
+    }
+    return snapshot->permission_names(user->id());
+}
 
-    for (const auto &role : roles) {
-        auto role_permissions =
-            permission_dao_->get_role_permissions(role->id());
-        for (const auto &perm : role_permissions) {
-            permissions.push_back(perm->name());
-        }
+bool UserService::assign_permission_to_role(const std::string &role_name,
+                                            const std::string &permission_name,
+                                            const std::shared_ptr<const models::User> &actor) {
+    auto role = user_dao_->get_role_by_name(role_name);
+    auto permission = permission_dao_->find_by_name(permission_name);
+    if (!role || !permission) {
+        log_service_->warning(models::ActionType::ROLE_UPDATED,
+                             "Grant failed - role or permission not found: " +
+                                 role_name + " / " + permission_name,
+                             actor, nullptr);
+        return false;
     }
 
-    std::sort(permissions.begin(), permissions.end());
-    permissions.erase(std::unique(permissions.begin(), permissions.end()),
-                      permissions.end());
+    bool result = permission_dao_->assign_permission_to_role(role->id(), permission->id());
+    if (result) {
+        authorization_changed();
+        log_service_->info(models::ActionType::ROLE_UPDATED,
+                          "Permission " + permission_name + " granted to role: " + role_name,
+                          actor, nullptr);
+    } else {
+        log_service_->error(models::ActionType::ROLE_UPDATED,
+                           "Failed to grant permission " + permission_name + " to role: " + role_name,
+                           actor, nullptr);
+    }
+    return result;
+}
 
-    return permissions;
+bool UserService::remove_permission_from_role(const std::string &role_name,
+                                              const std::string &permission_name,
+                                              const std::shared_ptr<const models::User> &actor) {
+    auto role = user_dao_->get_role_by_name(role_name);
+    auto permission = permission_dao_->find_by_name(permission_name);
+    if (!role || !permission) {
+        log_service_->warning(models::ActionType::ROLE_UPDATED,
+                             "Revoke failed - role or permission not found: " +
+                                 role_name + " / " + permission_name,
+                             actor, nullptr);
+        return false;
+    }
+
+    bool result = permission_dao_->remove_permission_from_role(role->id(), permission->id());
+    if (result) {
+        refresh_authorization();
+        // Набор разрешений зашит в токены членов роли: их сессии отзываются
+        if (revocations_) {
+            for (const auto &user_id : authorization()->members_of(role_name)) {
+                if (!revocations_->revoke(user_id, "role permission removed")) {
+                    log_service_->error(models::ActionType::SECURITY_VIOLATION,
+                                       "Failed to revoke sessions (role permission removed) for user: " + user_id,
+                                       actor, nullptr);
+                }
+            }
+        }
+        log_service_->info(models::ActionType::ROLE_UPDATED,
+                          "Permission " + permission_name + " revoked from role: " + role_name,
+                          actor, nullptr);
+    } else {
+        log_service_->error(models::ActionType::ROLE_UPDATED,
+                           "Failed to revoke permission " + permission_name + " from role: " + role_name,
+                           actor, nullptr);
+    }
+    return result;
 }
 
 std::shared_ptr<models::UserRole> UserService::get_role_by_name(const std::string& role_name) {
@@ -257,6 +541,11 @@ std::vector<models::User> UserService::get_all_users() {
     return result;
 }
 
+bool UserService::for_each_user(const std::function<bool(const models::UserView &)> &callback,
+                                bool active_only) {
+    return user_dao_->for_each_user(callback, active_only);
+}
+
 bool UserService::delete_user(const std::string &email, const std::shared_ptr<const models::User>& actor) {
     auto user = user_dao_->find_by_email(email);
     if (!user) {
@@ -268,6 +557,8 @@ bool UserService::delete_user(const std::string &email, const std::shared_ptr<co
 
     bool result = user_dao_->delete_by_id(user->id());
     if (result) {
+        revoke_sessions(user, "deleted");
+        authorization_changed();
         log_service_->info(models::ActionType::USER_DELETED,
                           "User deleted successfully: " + email,
                           actor, user);
@@ -279,6 +570,40 @@ bool UserService::delete_user(const std::string &email, const std::shared_ptr<co
     return result;
 }
 
+bool UserService::deactivate_user(const std::string &email, const std::shared_ptr<const models::User>& actor) {
+    auto user = user_dao_->find_by_email(email);
+    if (!user) {
+        log_service_->warning(models::ActionType::USER_STATUS_CHANGED,
+                             "User deactivation failed - user not found: " + email,
+                             actor, nullptr);
+        return false;
+    }
+
+    bool result = user_dao_->deactivate_user(user);
+    if (result) {
+        revoke_sessions(user, "deactivated");
+        log_service_->info(models::ActionType::USER_STATUS_CHANGED,
+                          "User deactivated: " + email,
+                          actor, user);
+    } else {
+        log_service_->error(models::ActionType::USER_STATUS_CHANGED,
+                           "User deactivation failed: " + email,
+                           actor, user);
+    }
+    return result;
+}
+
+void UserService::revoke_sessions(const std::shared_ptr<models::User> &user, const std::string &reason) {
+    if (!revocations_) {
+        return;
+    }
+    if (!revocations_->revoke(user->id(), reason)) {
+        log_service_->error(models::ActionType::SECURITY_VIOLATION,
+                           "Failed to revoke sessions (" + reason + ") for user: " + user->email(),
+                           nullptr, user);
+    }
+}
+
 bool UserService::add_role_to_user(const std::string &email, 
                                   const std::shared_ptr<models::UserRole> role,
                                   const std::shared_ptr<const models::User>& actor) {
@@ -292,6 +617,7 @@ bool UserService::add_role_to_user(const std::string &email,
 
     bool result = user_dao_->assign_role(user, role);
     if (result) {
+        authorization_changed();
         log_service_->info(models::ActionType::USER_ROLE_CHANGED,
                           "Role " + role->name() + " added to user: " + email,
                           actor, user);
@@ -318,6 +644,8 @@ bool UserService::remove_role_from_user(const std::string &email,
     bool result = user_dao_->remove_role(user_ptr, role_ptr);
     
     if (result) {
+        revoke_sessions(user_ptr, "role removed: " + role.name());
+        authorization_changed();
         log_service_->info(models::ActionType::USER_ROLE_CHANGED,
                           "Role " + role.name() + " removed from user: " + email,
                           actor, user_ptr);
@@ -333,8 +661,7 @@ bool UserService::is_admin(const std::shared_ptr<const models::User> &user) cons
     if (!user) {
         return false;
     }
-    auto non_const_user = std::const_pointer_cast<models::User>(user);
-    return user_dao_->has_role(non_const_user, "ADMIN");
+    return has_role(user, "ADMIN");
 }
 
 bool UserService::can_manage_users(const std::shared_ptr<const models::User> &user) const {
@@ -342,9 +669,16 @@ bool UserService::can_manage_users(const std::shared_ptr<const models::User> &us
         return false;
     }
 
-    return has_permission(user, "USER_CREATE") ||
-           has_permission(user, "USER_UPDATE") ||
-           has_permission(user, "USER_DELETE");
+    auto snapshot = authorization();
+    if (!snapshot) {
+        return false;
+    }
+
+    PermissionSet manage;
+    manage.set(static_cast<size_t>(models::AccessPermissionType::USER_CREATE));
+    manage.set(static_cast<size_t>(models::AccessPermissionType::USER_UPDATE));
+    manage.set(static_cast<size_t>(models::AccessPermissionType::USER_DELETE));
+    return (snapshot->permissions_of(user->id()) & manage).any();
 }
 
 bool UserService::has_role(const std::shared_ptr<const models::User> &user,
@@ -352,8 +686,8 @@ bool UserService::has_role(const std::shared_ptr<const models::User> &user,
     if (!user || role_name.empty()) {
         return false;
     }
-    auto non_const_user = std::const_pointer_cast<models::User>(user);
-    return user_dao_->has_role(non_const_user, role_name);
+    auto snapshot = authorization();
+    return snapshot && snapshot->has_role(user->id(), role_name);
 }
 
 bool UserService::requires_password_change(
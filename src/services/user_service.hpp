@@ -8,12 +8,22 @@
 #include "src/models/user.hpp"
 #include "src/models/user_role.hpp"
 #include "log_service.hpp"
+#include "authorization_snapshot.hpp"
+#include "revocation_list.hpp"
+#include "src/utils/hashing_worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
 namespace services {
+
+// Наибольший возраст снимка RBAC
+constexpr std::chrono::seconds AUTHORIZATION_TTL{60};
 struct CreateUserResult {
     bool success = false;
     std::string message = "";
@@ -21,6 +31,21 @@ struct CreateUserResult {
     std::string generated_password = "";
 };
 
+struct BulkUserRequest {
+    std::string email;
+    std::string first_name;
+    std::string last_name;
+    // Пусто - роль USER
+    std::vector<std::string> roles = {};
+};
+
+struct BulkUserResult {
+    std::string email;
+    bool success = false;
+    std::string message;
+    std::string generated_password = "";
+};
+
 class UserService {
 public:
     // Обновленный конструктор с AccessPermissionDAO
@@ -28,7 +53,9 @@ public:
         std::shared_ptr<IOHandler> io_handler,
         std::shared_ptr<dao::UserDAO> user_dao,
         std::shared_ptr<dao::AccessPermissionDAO> permission_dao,
-    std::shared_ptr<LogService> log_service);
+    std::shared_ptr<LogService> log_service,
+    std::shared_ptr<RevocationList> revocations = nullptr,
+    std::shared_ptr<utils::HashingWorkerPool> hashing_pool = nullptr);
 
     // Системная инициализация
     void initialize_system();
@@ -37,6 +64,9 @@ public:
     // Search
     std::shared_ptr<models::User> find_by_email(const std::string &email);
     std::vector<models::User> get_all_users();
+    // Обход без загрузки всех пользователей в память; false из callback останавливает обход
+    bool for_each_user(const std::function<bool(const models::UserView &)> &callback,
+                       bool active_only = false);
 
     // Create
     CreateUserResult
@@ -44,9 +74,17 @@ public:
                 const std::string &email, const std::string &role_name = "USER",
                 const std::shared_ptr<const models::User> &actor = nullptr);
 
+    // Массовое создание: проверка в памяти, хеши паролей на всех ядрах, вставка
+    // пользователей и ролей одной транзакцией. Результаты - в порядке запросов.
+    std::vector<BulkUserResult>
+    create_users_bulk(const std::vector<BulkUserRequest> &requests,
+                      const std::shared_ptr<const models::User> &actor = nullptr);
+
     // Delete
     bool delete_user(const std::string &email,
                      const std::shared_ptr<const models::User> &actor = nullptr);
+    bool deactivate_user(const std::string &email,
+                         const std::shared_ptr<const models::User> &actor = nullptr);
     bool add_role_to_user(const std::string &email,
                           const std::shared_ptr<models::UserRole> role,
                           const std::shared_ptr<const models::User> &actor = nullptr);
@@ -73,12 +111,46 @@ public:
     std::shared_ptr<models::UserRole>
     get_role_by_name(const std::string &role_name);
 
+    bool assign_permission_to_role(const std::string &role_name,
+                                   const std::string &permission_name,
+                                   const std::shared_ptr<const models::User> &actor = nullptr);
+    bool remove_permission_from_role(const std::string &role_name,
+                                     const std::string &permission_name,
+                                     const std::shared_ptr<const models::User> &actor = nullptr);
+
+    // Перечитывает роли и разрешения из БД и атомарно подменяет снимок. Изменения
+    // из других процессов попадают в снимок не позже чем через AUTHORIZATION_TTL.
+    void refresh_authorization() const;
+    // Пакетный режим: изменения ролей только помечают снимок устаревшим, resume
+    // перечитывает его один раз, если что-то менялось
+    void defer_authorization_refresh();
+    void resume_authorization_refresh();
+    // Сбрасывает кэш пользователей после изменений в обход UserDAO (импорт)
+    void invalidate_user_cache();
+
 private:
     std::shared_ptr<IOHandler> io_handler_;
     std::shared_ptr<dao::UserDAO> user_dao_;
     std::shared_ptr<dao::AccessPermissionDAO> permission_dao_;
     std::shared_ptr<services::LogService> log_service_;
+    std::shared_ptr<RevocationList> revocations_;
+    // Пул PBKDF2, общий с AuthService; без него хеши считаются в вызывающем потоке
+    std::shared_ptr<utils::HashingWorkerPool> hashing_pool_;
+
+    // Снимок RBAC: читатели берут его через std::atomic_load без блокировок,
+    // перестроение публикует новый через std::atomic_store
+    mutable std::shared_ptr<const AuthorizationSnapshot> authorization_;
+    mutable std::mutex authorization_rebuild_mutex_;
+    std::atomic<bool> authorization_deferred_{false};
+    std::atomic<bool> authorization_dirty_{false};
+
+    std::shared_ptr<const AuthorizationSnapshot> authorization() const;
+    void rebuild_authorization() const;
+    // После изменения ролей в этом процессе: перечитать снимок сейчас или в resume
+    void authorization_changed();
 
     bool create_system_roles();
+    // Отзывает выданные пользователю токены сессии, если список отзыва подключён
+    void revoke_sessions(const std::shared_ptr<models::User> &user, const std::string &reason);
 };
 } // namespace services
\ No newline at end of file
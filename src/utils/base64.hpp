@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace utils {
+
+// base64url без выравнивания (RFC 4648, раздел 5): безопасен в аргументах CLI и URL
+class Base64Url {
+public:
+    static std::string encode(std::string_view data) {
+        static const char alphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        std::string out;
+        out.reserve((data.size() + 2) / 3 * 4);
+
+        size_t i = 0;
+        for (; i + 2 < data.size(); i += 3) {
+            uint32_t chunk = (static_cast<uint8_t>(data[i]) << 16) |
+                             (static_cast<uint8_t>(data[i + 1]) << 8) |
+                             static_cast<uint8_t>(data[i + 2]);
+            out += alphabet[(chunk >> 18) & 0x3F];
+            out += alphabet[(chunk >> 12) & 0x3F];
+            out += alphabet[(chunk >> 6) & 0x3F];
+            out += alphabet[chunk & 0x3F];
+        }
+
+        size_t rest = data.size() - i;
+        if (rest == 1) {
+            uint32_t chunk = static_cast<uint8_t>(data[i]) << 16;
+            out += alphabet[(chunk >> 18) & 0x3F];
+            out += alphabet[(chunk >> 12) & 0x3F];
+        } else if (rest == 2) {
+            uint32_t chunk = (static_cast<uint8_t>(data[i]) << 16) |
+                             (static_cast<uint8_t>(data[i + 1]) << 8);
+            out += alphabet[(chunk >> 18) & 0x3F];
+            out += alphabet[(chunk >> 12) & 0x3F];
+            out += alphabet[(chunk >> 6) & 0x3F];
+        }
+        return out;
+    }
+
+    static std::optional<std::string> decode(std::string_view text) {
+        if (text.size() % 4 == 1) {
+            return std::nullopt;
+        }
+
+        std::string out;
+        out.reserve(text.size() * 3 / 4);
+
+        uint32_t buffer = 0;
+        int bits = 0;
+        for (char c : text) {
+            int value = decode_char(c);
+            if (value < 0) {
+                return std::nullopt;
+            }
+            buffer = (buffer << 6) | static_cast<uint32_t>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out += static_cast<char>((buffer >> bits) & 0xFF);
+            }
+        }
+        return out;
+    }
+
+private:
+    static int decode_char(char c) {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '-') return 62;
+        if (c == '_') return 63;
+        return -1;
+    }
+};
+
+} // namespace utils
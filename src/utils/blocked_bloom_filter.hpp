@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+// Блочный фильтр Блума: все биты одного ключа лежат в одном 64-байтовом блоке,
+// поэтому проверка читает ровно одну кэш-линию. Ложноположительные ответы
+// возможны, ложноотрицательные - нет.
+class BlockedBloomFilter {
+public:
+    static constexpr size_t BLOCK_BITS = 512;
+    static constexpr size_t BITS_PER_KEY = 10;
+    static constexpr size_t HASHES = 7;
+
+    explicit BlockedBloomFilter(size_t expected_keys = 1024)
+        : capacity_(std::max<size_t>(expected_keys, 1)),
+          blocks_((capacity_ * BITS_PER_KEY + BLOCK_BITS - 1) / BLOCK_BITS) {}
+
+    void insert(std::string_view key) {
+        uint64_t hash = mix(std::hash<std::string_view>{}(key));
+        auto& block = blocks_[block_index(hash)];
+        for_each_bit(hash, [&](size_t bit) { block.words[bit / 64] |= uint64_t{1} << (bit % 64); });
+    }
+
+    bool may_contain(std::string_view key) const {
+        uint64_t hash = mix(std::hash<std::string_view>{}(key));
+        const auto& block = blocks_[block_index(hash)];
+        bool present = true;
+        for_each_bit(hash, [&](size_t bit) {
+            present &= ((block.words[bit / 64] >> (bit % 64)) & 1u) != 0;
+        });
+        return present;
+    }
+
+    void clear() {
+        std::fill(blocks_.begin(), blocks_.end(), Block{});
+    }
+
+    // Число ключей, на которое рассчитан размер; при превышении растёт доля ложных срабатываний
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(64) Block {
+        std::array<uint64_t, BLOCK_BITS / 64> words{};
+    };
+
+    // splitmix64: std::hash для строк может плохо перемешивать старшие биты
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    size_t block_index(uint64_t hash) const {
+        return static_cast<size_t>((hash >> 32) % blocks_.size());
+    }
+
+    // Двойное хеширование внутри блока по младшим 32 битам
+    template <typename F>
+    static void for_each_bit(uint64_t hash, F&& f) {
+        uint32_t h1 = static_cast<uint32_t>(hash);
+        uint32_t h2 = (h1 >> 16) | (h1 << 16) | 1u;
+        for (size_t i = 0; i < HASHES; ++i) {
+            f((h1 + static_cast<uint32_t>(i) * h2) % BLOCK_BITS);
+        }
+    }
+
+    size_t capacity_;
+    std::vector<Block> blocks_;
+};
+
+} // namespace utils
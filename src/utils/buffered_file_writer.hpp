@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+// Запись в файл через буфер фиксированного размера: память не растёт с объёмом выгрузки
+class BufferedFileWriter {
+public:
+    explicit BufferedFileWriter(const std::string& path, size_t buffer_size = 1 << 20)
+        : file_(std::fopen(path.c_str(), "wb")) {
+        buffer_.reserve(buffer_size);
+    }
+
+    ~BufferedFileWriter() { close(); }
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+    bool good() const { return file_ != nullptr && !failed_; }
+    size_t bytes_written() const { return bytes_written_ + buffer_.size(); }
+
+    void write(std::string_view data) {
+        if (buffer_.size() + data.size() > buffer_.capacity()) {
+            flush();
+            if (data.size() > buffer_.capacity()) {
+                write_through(data.data(), data.size());
+                return;
+            }
+        }
+        buffer_.insert(buffer_.end(), data.begin(), data.end());
+    }
+
+    void put(char c) {
+        if (buffer_.size() == buffer_.capacity()) {
+            flush();
+        }
+        buffer_.push_back(c);
+    }
+
+    void flush() {
+        if (!buffer_.empty()) {
+            write_through(buffer_.data(), buffer_.size());
+            buffer_.clear();
+        }
+    }
+
+    // false, если при записи была ошибка
+    bool close() {
+        if (!file_) {
+            return false;
+        }
+        flush();
+        if (std::fclose(file_) != 0) {
+            failed_ = true;
+        }
+        file_ = nullptr;
+        return !failed_;
+    }
+
+private:
+    void write_through(const char* data, size_t size) {
+        if (!file_ || failed_) {
+            return;
+        }
+        if (std::fwrite(data, 1, size, file_) != size) {
+            failed_ = true;
+        }
+        bytes_written_ += size;
+    }
+
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    size_t bytes_written_ = 0;
+    bool failed_ = false;
+};
+
+} // namespace utils
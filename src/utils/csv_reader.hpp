@@ -0,0 +1,62 @@
+#pragma once
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace utils {
+
+// Потоковый разбор CSV по RFC 4180: поля в кавычках могут содержать
+// запятые, удвоенные кавычки и переводы строк. Читает по одной записи.
+class CsvReader {
+public:
+    explicit CsvReader(std::istream& in) : in_(in) {}
+
+    // false в конце файла
+    bool read_record(std::vector<std::string>& fields) {
+        fields.clear();
+        std::string field;
+        bool in_quotes = false;
+        bool any = false;
+
+        char c;
+        while (in_.get(c)) {
+            any = true;
+            if (in_quotes) {
+                if (c == '"') {
+                    if (in_.peek() == '"') {
+                        in_.get();
+                        field += '"';
+                    } else {
+                        in_quotes = false;
+                    }
+                } else {
+                    field += c;
+                }
+            } else if (c == '"') {
+                in_quotes = true;
+            } else if (c == ',') {
+                fields.push_back(std::move(field));
+                field.clear();
+            } else if (c == '\n') {
+                break;
+            } else if (c != '\r') {
+                field += c;
+            }
+        }
+
+        if (!any) {
+            return false;
+        }
+        fields.push_back(std::move(field));
+        ++line_;
+        return true;
+    }
+
+    size_t records_read() const { return line_; }
+
+private:
+    std::istream& in_;
+    size_t line_ = 0;
+};
+
+} // namespace utils
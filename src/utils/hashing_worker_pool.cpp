@@ -0,0 +1,151 @@
+#include "hashing_worker_pool.hpp"
+#include "password_utils.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace utils {
+
+HashingWorkerPool::HashingWorkerPool(HashingPoolConfig config) : config_(config) {
+    if (config_.threads == 0) {
+        config_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    config_.max_pending = std::max<size_t>(config_.max_pending, 1);
+    config_.max_pending_per_key = std::max<size_t>(config_.max_pending_per_key, 1);
+
+    workers_.reserve(config_.threads);
+    for (size_t i = 0; i < config_.threads; ++i) {
+        workers_.emplace_back(&HashingWorkerPool::worker_loop, this);
+    }
+}
+
+HashingWorkerPool::~HashingWorkerPool() {
+    shutdown();
+}
+
+std::future<VerifyStatus> HashingWorkerPool::verify_async(const std::string& key, std::string password,
+                                                          std::string stored_hash) {
+    auto task = std::make_shared<std::packaged_task<VerifyStatus()>>(
+        [password = std::move(password), stored_hash = std::move(stored_hash)] {
+            return PasswordUtils::verify_password_pbkdf2(password, stored_hash)
+                       ? VerifyStatus::VERIFIED
+                       : VerifyStatus::MISMATCH;
+        });
+    auto future = task->get_future();
+
+    if (submit(key, [task] { (*task)(); }) != Admission::ACCEPTED) {
+        std::promise<VerifyStatus> rejected;
+        rejected.set_value(VerifyStatus::REJECTED);
+        return rejected.get_future();
+    }
+    return future;
+}
+
+std::future<std::optional<std::string>> HashingWorkerPool::hash_async(const std::string& key,
+                                                                      std::string password) {
+    auto task = std::make_shared<std::packaged_task<std::optional<std::string>()>>(
+        [password = std::move(password)]() -> std::optional<std::string> {
+            return PasswordUtils::hash_password_pbkdf2(password);
+        });
+    auto future = task->get_future();
+
+    if (submit(key, [task] { (*task)(); }) != Admission::ACCEPTED) {
+        std::promise<std::optional<std::string>> rejected;
+        rejected.set_value(std::nullopt);
+        return rejected.get_future();
+    }
+    return future;
+}
+
+HashingWorkerPool::Admission HashingWorkerPool::submit(const std::string& key, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || pending_ >= config_.max_pending) {
+            ++rejected_global_;
+            return Admission::REJECTED_GLOBAL;
+        }
+
+        auto& queue = queues_[key];
+        if (queue.tasks.size() + queue.in_flight >= config_.max_pending_per_key) {
+            ++rejected_per_key_;
+            return Admission::REJECTED_PER_KEY;
+        }
+
+        if (queue.tasks.empty()) {
+            ready_keys_.push_back(key);
+        }
+        queue.tasks.push_back(std::move(task));
+        ++pending_;
+    }
+    available_.notify_one();
+    return Admission::ACCEPTED;
+}
+
+void HashingWorkerPool::worker_loop() {
+    while (true) {
+        Task task;
+        std::string key;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this] { return stopping_ || !ready_keys_.empty(); });
+            if (ready_keys_.empty()) {
+                return; // stopping_ и очередь пуста
+            }
+
+            key = std::move(ready_keys_.front());
+            ready_keys_.pop_front();
+
+            auto& queue = queues_[key];
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            ++queue.in_flight;
+            // Ключ с оставшимися задачами встаёт в конец круга
+            if (!queue.tasks.empty()) {
+                ready_keys_.push_back(key);
+            }
+        }
+
+        task();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = queues_.find(key);
+        if (it != queues_.end()) {
+            --it->second.in_flight;
+            if (it->second.in_flight == 0 && it->second.tasks.empty()) {
+                queues_.erase(it);
+            }
+        }
+        --pending_;
+        ++completed_;
+    }
+}
+
+HashingPoolStats HashingWorkerPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HashingPoolStats snapshot;
+    snapshot.threads = workers_.size();
+    snapshot.pending = pending_;
+    snapshot.active_keys = queues_.size();
+    snapshot.completed = completed_;
+    snapshot.rejected_global = rejected_global_;
+    snapshot.rejected_per_key = rejected_per_key_;
+    return snapshot;
+}
+
+// Уже принятые задачи выполняются до конца, новые отклоняются
+void HashingWorkerPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    available_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+} // namespace utils
@@ -0,0 +1,88 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+
+enum class VerifyStatus {
+    VERIFIED,
+    MISMATCH,
+    REJECTED // не принято пулом: превышен лимит очереди
+};
+
+struct HashingPoolConfig {
+    // 0 - по числу ядер
+    size_t threads = 0;
+    // Общий лимит задач в очереди и в работе
+    size_t max_pending = 256;
+    // Лимит задач одного ключа (учётной записи): перебор паролей одной
+    // учётной записи не может занять всю очередь
+    size_t max_pending_per_key = 4;
+};
+
+struct HashingPoolStats {
+    size_t threads = 0;
+    size_t pending = 0;
+    size_t active_keys = 0;
+    uint64_t completed = 0;
+    uint64_t rejected_global = 0;
+    uint64_t rejected_per_key = 0;
+};
+
+// Пул потоков для PBKDF2. Задачи группируются по ключу и выбираются по кругу,
+// поэтому поток запросов к одной учётной записи не задерживает остальные.
+class HashingWorkerPool {
+public:
+    explicit HashingWorkerPool(HashingPoolConfig config = {});
+    ~HashingWorkerPool();
+
+    HashingWorkerPool(const HashingWorkerPool&) = delete;
+    HashingWorkerPool& operator=(const HashingWorkerPool&) = delete;
+
+    std::future<VerifyStatus> verify_async(const std::string& key, std::string password,
+                                           std::string stored_hash);
+    // nullopt, если задача не принята
+    std::future<std::optional<std::string>> hash_async(const std::string& key, std::string password);
+
+    HashingPoolStats stats() const;
+    void shutdown();
+
+private:
+    using Task = std::function<void()>;
+
+    struct KeyQueue {
+        std::deque<Task> tasks;
+        size_t in_flight = 0;
+    };
+
+    enum class Admission { ACCEPTED, REJECTED_GLOBAL, REJECTED_PER_KEY };
+
+    Admission submit(const std::string& key, Task task);
+    void worker_loop();
+
+    HashingPoolConfig config_;
+    std::vector<std::thread> workers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::unordered_map<std::string, KeyQueue> queues_;
+    // Ключи с ожидающими задачами в порядке обслуживания
+    std::deque<std::string> ready_keys_;
+    size_t pending_ = 0;
+    bool stopping_ = false;
+
+    uint64_t completed_ = 0;
+    uint64_t rejected_global_ = 0;
+    uint64_t rejected_per_key_ = 0;
+};
+
+} // namespace utils
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cctype>
 #include <iomanip>
+#include <memory>
 #include <openssl/evp.h>
 #include <openssl/kdf.h>
 #include <openssl/rand.h>
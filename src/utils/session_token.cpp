@@ -0,0 +1,108 @@
+#include "session_token.hpp"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <stdexcept>
+#include "base64.hpp"
+
+namespace utils {
+
+namespace {
+constexpr uint8_t TOKEN_VERSION = 1;
+// Версия, время выдачи, срок действия, разрешения; дальше - id пользователя
+constexpr size_t HEADER_SIZE = 1 + 8 + 8 + 8;
+
+void put_u64(std::string& out, uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+uint64_t get_u64(std::string_view data, size_t offset) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value = (value << 8) | static_cast<uint8_t>(data[offset + i]);
+    }
+    return value;
+}
+
+int64_t to_unix(std::chrono::system_clock::time_point tp) {
+    return std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point from_unix(int64_t seconds) {
+    return std::chrono::system_clock::time_point(std::chrono::seconds(seconds));
+}
+} // namespace
+
+SessionTokenSigner::SessionTokenSigner(SessionTokenConfig config) : config_(std::move(config)) {
+    if (config_.key.empty()) {
+        config_.key.resize(32);
+        if (RAND_bytes(reinterpret_cast<unsigned char*>(config_.key.data()),
+                       static_cast<int>(config_.key.size())) != 1) {
+            throw std::runtime_error("Failed to generate session token key");
+        }
+    }
+}
+
+std::string SessionTokenSigner::sign(std::string_view data) const {
+    unsigned char mac[EVP_MAX_MD_SIZE];
+    unsigned int mac_size = 0;
+    if (HMAC(EVP_sha256(), config_.key.data(), static_cast<int>(config_.key.size()),
+             reinterpret_cast<const unsigned char*>(data.data()), data.size(), mac, &mac_size) == nullptr) {
+        throw std::runtime_error("HMAC computation failed");
+    }
+    return std::string(reinterpret_cast<const char*>(mac), mac_size);
+}
+
+std::string SessionTokenSigner::issue(const std::string& user_id, uint64_t permissions) const {
+    auto now = std::chrono::system_clock::now();
+
+    std::string payload;
+    payload.reserve(HEADER_SIZE + user_id.size());
+    payload += static_cast<char>(TOKEN_VERSION);
+    put_u64(payload, static_cast<uint64_t>(to_unix(now)));
+    put_u64(payload, static_cast<uint64_t>(to_unix(now + config_.ttl)));
+    put_u64(payload, permissions);
+    payload += user_id;
+
+    std::string encoded = Base64Url::encode(payload);
+    return encoded + "." + Base64Url::encode(sign(encoded));
+}
+
+std::optional<SessionClaims> SessionTokenSigner::verify(std::string_view token,
+                                                        std::chrono::system_clock::time_point now) const {
+    size_t dot = token.find('.');
+    if (dot == std::string_view::npos) {
+        return std::nullopt;
+    }
+    std::string_view encoded = token.substr(0, dot);
+
+    auto mac = Base64Url::decode(token.substr(dot + 1));
+    std::string expected = sign(encoded);
+    // Сравнение за постоянное время: время ответа не выдаёт совпавший префикс подписи
+    if (!mac || mac->size() != expected.size() ||
+        CRYPTO_memcmp(mac->data(), expected.data(), expected.size()) != 0) {
+        return std::nullopt;
+    }
+
+    auto payload = Base64Url::decode(encoded);
+    if (!payload || payload->size() <= HEADER_SIZE ||
+        static_cast<uint8_t>((*payload)[0]) != TOKEN_VERSION) {
+        return std::nullopt;
+    }
+
+    SessionClaims claims;
+    claims.issued_at = from_unix(static_cast<int64_t>(get_u64(*payload, 1)));
+    claims.expires_at = from_unix(static_cast<int64_t>(get_u64(*payload, 9)));
+    claims.permissions = get_u64(*payload, 17);
+    claims.user_id = payload->substr(HEADER_SIZE);
+
+    if (claims.expires_at <= now) {
+        return std::nullopt;
+    }
+    return claims;
+}
+
+} // namespace utils
@@ -0,0 +1,53 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "src/models/enums.hpp"
+
+namespace utils {
+
+static_assert(models::ACCESS_PERMISSION_TYPE_COUNT <= 64,
+              "permission bitset in a session token is 64 bits wide");
+
+struct SessionClaims {
+    std::string user_id;
+    // Бит i - разрешение AccessPermissionType(i) на момент выдачи токена
+    uint64_t permissions = 0;
+    std::chrono::system_clock::time_point issued_at;
+    std::chrono::system_clock::time_point expires_at;
+
+    bool has_permission(models::AccessPermissionType permission) const {
+        return (permissions >> static_cast<size_t>(permission)) & 1u;
+    }
+};
+
+struct SessionTokenConfig {
+    // Ключ HMAC; пустой - случайный ключ процесса (токены не переживают перезапуск)
+    std::string key;
+    std::chrono::seconds ttl{3600};
+};
+
+// Подписанный токен сессии: base64url(данные) "." base64url(HMAC-SHA256).
+// Проверка не обращается к базе - достаточно ключа.
+class SessionTokenSigner {
+public:
+    explicit SessionTokenSigner(SessionTokenConfig config = {});
+
+    std::string issue(const std::string& user_id, uint64_t permissions) const;
+
+    // nullopt, если подпись неверна, формат повреждён или срок истёк
+    std::optional<SessionClaims> verify(std::string_view token,
+                                        std::chrono::system_clock::time_point now =
+                                            std::chrono::system_clock::now()) const;
+
+    std::chrono::seconds ttl() const { return config_.ttl; }
+
+private:
+    std::string sign(std::string_view data) const;
+
+    SessionTokenConfig config_;
+};
+
+} // namespace utils
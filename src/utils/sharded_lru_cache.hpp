@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+// Ограниченный LRU-кэш с временем жизни записей. Ключи распределены по
+// сегментам со своими мьютексами, чтобы потоки не ждали друг друга.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit ShardedLruCache(size_t capacity, size_t shard_count = 16)
+        : shards_(std::max<size_t>(shard_count, 1)) {
+        size_t per_shard = (capacity + shards_.size() - 1) / shards_.size();
+        for (auto& shard : shards_) {
+            shard.capacity = std::max<size_t>(per_shard, 1);
+        }
+    }
+
+    // nullopt, если записи нет или её срок истёк
+    std::optional<Value> get(const Key& key) {
+        auto& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return std::nullopt;
+        }
+        if (it->second->expires_at <= clock::now()) {
+            shard.entries.erase(it->second);
+            shard.index.erase(it);
+            return std::nullopt;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->value;
+    }
+
+    void put(const Key& key, Value value, clock::duration ttl) {
+        auto& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto expires_at = clock::now() + ttl;
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->value = std::move(value);
+            it->second->expires_at = expires_at;
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return;
+        }
+
+        shard.entries.push_front(Entry{key, std::move(value), expires_at});
+        shard.index.emplace(key, shard.entries.begin());
+        if (shard.entries.size() > shard.capacity) {
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+        }
+    }
+
+    void erase(const Key& key) {
+        auto& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.entries.erase(it->second);
+            shard.index.erase(it);
+        }
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.clear();
+            shard.entries.clear();
+        }
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        clock::time_point expires_at;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> entries; // голова - последние использованные
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+        size_t capacity = 1;
+    };
+
+    Shard& shard_for(const Key& key) {
+        return shards_[Hash{}(key) % shards_.size()];
+    }
+
+    std::vector<Shard> shards_;
+};
+
+} // namespace utils
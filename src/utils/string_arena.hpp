@@ -0,0 +1,65 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+// Хранилище строк с выделением памяти крупными блоками. Возвращённые
+// string_view действительны, пока жива арена (и после её перемещения).
+class StringArena {
+public:
+    explicit StringArena(size_t chunk_size = 64 * 1024) : chunk_size_(chunk_size) {}
+
+    StringArena(StringArena&& other) noexcept { *this = std::move(other); }
+    StringArena& operator=(StringArena&& other) noexcept {
+        chunks_ = std::move(other.chunks_);
+        cursor_ = std::exchange(other.cursor_, nullptr);
+        remaining_ = std::exchange(other.remaining_, 0);
+        chunk_size_ = other.chunk_size_;
+        bytes_used_ = std::exchange(other.bytes_used_, 0);
+        other.chunks_.clear();
+        return *this;
+    }
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    std::string_view store(std::string_view value) {
+        if (value.empty()) {
+            return {};
+        }
+        if (value.size() > remaining_) {
+            // Длинная строка получает собственный блок, текущий остаётся в работе
+            if (value.size() > chunk_size_ / 4) {
+                chunks_.push_back(std::make_unique<char[]>(value.size()));
+                std::memcpy(chunks_.back().get(), value.data(), value.size());
+                bytes_used_ += value.size();
+                return {chunks_.back().get(), value.size()};
+            }
+            chunks_.push_back(std::make_unique<char[]>(chunk_size_));
+            cursor_ = chunks_.back().get();
+            remaining_ = chunk_size_;
+        }
+        std::memcpy(cursor_, value.data(), value.size());
+        std::string_view stored(cursor_, value.size());
+        cursor_ += value.size();
+        remaining_ -= value.size();
+        bytes_used_ += value.size();
+        return stored;
+    }
+
+    size_t bytes_used() const { return bytes_used_; }
+    size_t chunk_count() const { return chunks_.size(); }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* cursor_ = nullptr;
+    size_t remaining_ = 0;
+    size_t chunk_size_ = 64 * 1024;
+    size_t bytes_used_ = 0;
+};
+
+} // namespace utils
@@ -1,42 +1,84 @@
 #pragma once
-#include <string>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <random>
-#include <sstream>
-#include <iomanip>
+#include <string>
 
 namespace utils {
 
+// UUIDv7 (RFC 9562): 48 бит времени в миллисекундах, затем 12-битный счётчик
+// и 62 случайных бита. Ключи растут со временем, поэтому вставки идут в правый
+// край индекса первичного ключа, а не в случайные страницы B-дерева.
+// Состояние у каждого потока своё - блокировки не нужны.
 class UUIDGenerator {
 private:
-    std::random_device rd_;
-    std::mt19937 gen_;
-    std::uniform_int_distribution<> dis_;
-    
+    std::mt19937_64 gen_;
+    uint64_t last_ms_ = 0;
+    uint16_t counter_ = 0;
+
+    static uint64_t seed() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
+
+    static uint64_t now_ms() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
 public:
-    UUIDGenerator() : gen_(rd_()), dis_(0, 15) {}
-    
+    UUIDGenerator() : gen_(seed()) {}
+
+    std::array<uint8_t, 16> generate_bytes() {
+        uint64_t ms = now_ms();
+        uint64_t random = gen_();
+        if (ms > last_ms_) {
+            last_ms_ = ms;
+            // Случайное начало счётчика с запасом на рост внутри миллисекунды
+            counter_ = static_cast<uint16_t>(random >> 53);
+        } else if (++counter_ > 0x0fff) {
+            // Счётчик исчерпан или часы пошли назад: занимаем следующую миллисекунду
+            ++last_ms_;
+            counter_ = 0;
+        }
+
+        std::array<uint8_t, 16> bytes;
+        for (int i = 0; i < 6; ++i) {
+            bytes[i] = static_cast<uint8_t>(last_ms_ >> (40 - 8 * i));
+        }
+        bytes[6] = static_cast<uint8_t>(0x70 | (counter_ >> 8));
+        bytes[7] = static_cast<uint8_t>(counter_);
+        for (int i = 8; i < 16; ++i) {
+            bytes[i] = static_cast<uint8_t>(random >> (8 * (i - 8)));
+        }
+        bytes[8] = static_cast<uint8_t>(0x80 | (bytes[8] & 0x3f)); // variant
+        return bytes;
+    }
+
     std::string generate() {
-        std::stringstream ss;
-        ss << std::hex;
-        
-        for (int i = 0; i < 8; i++) ss << dis_(gen_);
-        ss << "-";
-        for (int i = 0; i < 4; i++) ss << dis_(gen_);
-        ss << "-4"; // version 4
-        for (int i = 0; i < 3; i++) ss << dis_(gen_);
-        ss << "-";
-        ss << (8 + dis_(gen_) % 4); // variant
-        for (int i = 0; i < 3; i++) ss << dis_(gen_);
-        ss << "-";
-        for (int i = 0; i < 12; i++) ss << dis_(gen_);
-        
-        return ss.str();
+        return format(generate_bytes());
     }
-    
+
+    // Каноническая запись 8-4-4-4-12 в нижнем регистре, как её выводит PostgreSQL
+    static std::string format(const std::array<uint8_t, 16>& bytes) {
+        static constexpr char HEX[] = "0123456789abcdef";
+        std::string out(36, '-');
+        size_t pos = 0;
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            if (i == 4 || i == 6 || i == 8 || i == 10) {
+                ++pos;
+            }
+            out[pos++] = HEX[bytes[i] >> 4];
+            out[pos++] = HEX[bytes[i] & 0x0f];
+        }
+        return out;
+    }
+
     static std::string generate_uuid() {
-        static UUIDGenerator generator;
+        thread_local UUIDGenerator generator;
         return generator.generate();
     }
 };
 
-}
\ No newline at end of file
+}